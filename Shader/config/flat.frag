@@ -1,11 +1,33 @@
 #version 330 core
 in vec3 vColor;
+in vec2 vLocal;
+flat in vec4 vSdf;
 out vec4 FragColor;
 
-uniform bool useOverrideColor;
-uniform vec3 uOverrideColor;
+// Approximate distance to an ellipse with radii r
+float sdEllipse(vec2 p, vec2 r) {
+    float k0 = length(p / r);
+    float k1 = length(p / (r * r));
+    if (k1 < 1e-6) return -min(r.x, r.y);
+    return k0 * (k0 - 1.0) / k1;
+}
+
+float sdRoundedBox(vec2 p, vec2 halfSize, float radius) {
+    vec2 q = abs(p) - halfSize + radius;
+    return length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+}
 
 void main() {
-    vec3 c = useOverrideColor ? uOverrideColor : vColor;
-    FragColor = vec4(c, 1.0);
+    float alpha = 1.0;
+
+    // Analytic primitives are quads; coverage fades over the last pixel
+    // inside the edge, so nothing has to be drawn outside the quad
+    if (vSdf.w > 0.5) {
+        float d = vSdf.w < 1.5 ? sdEllipse(vLocal, vSdf.xy)
+                               : sdRoundedBox(vLocal, vSdf.xy, vSdf.z);
+        alpha = clamp(-d / max(fwidth(d), 1e-6), 0.0, 1.0);
+        if (alpha <= 0.0) discard;
+    }
+
+    FragColor = vec4(vColor, alpha);
 }
@@ -3,9 +3,16 @@
 #include "../input/Input.h"
 #include "../Renderer/Renderer2D.hpp"
 #include "../Renderer/Shader/Shader.hpp"
+#include "../Renderer/RenderThread.hpp"
+#include "../Renderer/ProfilerOverlay.hpp"
+#include "../Renderer/OffscreenTarget.hpp"
+#include "../Renderer/RenderBackend.hpp"
+#include "../core/Profiler.h"
 #include <cstdio>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
+#include <chrono>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
@@ -35,13 +42,18 @@ void Application::run() {
 void Application::initialize() {
     std::cout << "Initializing application..." << std::endl;
     glfwSetErrorCallback(onGlfwError);
-    if (!glfwInit()) {
+    if (!Window::initGlfw(m_Mode)) {
         throw std::runtime_error("Failed to initialize GLFW");
     }
 
-    m_Window = std::make_unique<Window>(m_Width, m_Height, m_Title);
+    m_Window = std::make_unique<Window>(m_Width, m_Height, m_Title, m_Mode);
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    // A fixed render rate is paced by waitForNextRender() instead of v-sync
+    if (m_RenderRate > 0.0 && m_Mode != WindowMode::Null) {
+        glfwSwapInterval(0);
+    }
+
+    if (!RenderBackend::load(RenderBackend::forMode(m_Mode))) {
         throw std::runtime_error("Failed to initialize GLAD");
     }
 
@@ -50,15 +62,53 @@ void Application::initialize() {
 
     std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
 
-    glfwSetFramebufferSizeCallback(m_Window->getNativeWindow(), onResize);
+    // Headless frames go to an FBO; everything after this draws into it as
+    // if it were the default framebuffer
+    if (m_Mode != WindowMode::Windowed) {
+        std::cout << "Headless: " << glGetString(GL_RENDERER) << std::endl;
+        m_Offscreen = std::make_unique<OffscreenTarget>(m_Width, m_Height);
+        m_Offscreen->bind();
+
+        if (m_FrameLimit < 0) {
+            m_FrameLimit = 1;
+        }
+    }
+
+    // With a render thread the viewport travels in the snapshot instead
+    if (!m_UseRenderThread && !m_Offscreen) {
+        glfwSetFramebufferSizeCallback(m_Window->getNativeWindow(), onResize);
+    }
     m_Input->initialize(m_Window->getNativeWindow());
 
     m_Shader = std::make_unique<Shader>(Shader::fromFiles("Shader/config/flat.vert", "Shader/config/flat.frag"));
+
+    const Shader::LoadInfo load = Shader::lastLoad();
+    std::cout << "Shader setup: " << load.milliseconds << " ms ("
+              << (load.fromBinaryCache ? "warm, cached binary" : "cold, compiled")
+              << (load.embeddedSource ? ", embedded source" : "") << ")" << std::endl;
     std::cout << "Initialization successful." << std::endl;
 }
 
 void Application::cleanup() {
     std::cout << "Cleaning up..." << std::endl;
+    m_RenderThread.reset();
+
+    // After the render thread, which hands the context back when it stops
+    if (m_Offscreen) {
+        if (!m_ScreenshotPath.empty() && m_Offscreen->savePpm(m_ScreenshotPath)) {
+            std::cout << "Frame written to " << m_ScreenshotPath << std::endl;
+        }
+        m_Offscreen.reset();
+    }
+
+    if (m_Profiling) {
+        if (Profiler::writeChromeTrace(m_TracePath)) {
+            std::cout << "Profile written to " << m_TracePath << std::endl;
+        }
+        Profiler::releaseGpuResources();
+        m_Overlay.reset();
+    }
+
     m_Shader.reset();
     m_Renderer.reset();
     m_Input.reset();
@@ -78,15 +128,50 @@ void Application::mainLoop() {
 
     glm::vec2 greenCenter = {0.25f, 0.25f};
 
-    while (!m_Window->shouldClose()) {
+    if (m_Profiling) {
+        Profiler::setEnabled(true);
+        Profiler::setThreadName("Main");
+        m_Overlay = std::make_unique<ProfilerOverlay>();
+    }
+
+    if (m_UseRenderThread) {
+        m_RenderThread = std::make_unique<RenderThread>(m_Window->getNativeWindow(), *m_Renderer, *m_Shader);
+    }
+
+    // Simulated clock, advanced only in fixed steps
+    double simTime = 0.0;
+    double previousSimTime = 0.0;
+
+    double lastTime = glfwGetTime();
+    double nextRender = lastTime;
+    const double startTime = lastTime;
+    RenderBackend::resetCounts();
+
+    int frames = 0;
+
+    while (!m_Window->shouldClose() && (m_FrameLimit <= 0 || frames < m_FrameLimit)) {
         glfwPollEvents();
-        glClearColor(0.1f, 0.1f, 0.12f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+        Profiler::beginFrame();
+
+        double now = glfwGetTime();
+        int steps = m_Timestep.advance(now - lastTime);
+        lastTime = now;
+
+        for (int i = 0; i < steps; ++i) {
+            previousSimTime = simTime;
+            simTime += m_Timestep.step();
+        }
 
-        float t = (float)glfwGetTime();
+        // Draw between the last two steps so motion stays smooth at any render rate
+        float t = (float)(previousSimTime + (simTime - previousSimTime) * m_Timestep.alpha());
         int w, h;
         glfwGetFramebufferSize(m_Window->getNativeWindow(), &w, &h);
 
+        if (m_Offscreen) {
+            w = m_Offscreen->getWidth();
+            h = m_Offscreen->getHeight();
+        }
+
         glm::mat4 greenModel = Transform::setIdentity();
         greenModel = Transform::translate(greenModel, greenCenter);
         greenModel = Transform::rotateZ_about(greenModel, 25.0f, greenCenter);
@@ -95,15 +180,36 @@ void Application::mainLoop() {
 
         glm::vec3 dynamicColor = { 0.5f + 0.5f*std::sin(t), 0.5f + 0.5f*std::cos(t), 0.7f };
 
-        m_Renderer->setModel(green, greenModel);
-        m_Renderer->setOverrideColor(green, dynamicColor);
-
         float aspect = (h == 0) ? 1.0f : (float)w / (float)h;
         glm::mat4 vp = glm::ortho(-aspect, aspect, -1.0f, 1.0f, -1.0f, 1.0f);
 
-        m_Renderer->drawAll(*m_Shader, vp);
+        if (m_RenderThread) {
+            RenderSnapshot& frame = m_RenderThread->beginFrame();
+            frame.setModel(green, greenModel);
+            frame.setOverrideColor(green, dynamicColor);
+            frame.viewProjection = vp;
+            frame.clearColor = {0.1f, 0.1f, 0.12f, 1.0f};
+            frame.framebufferSize = {w, h};
+
+            m_RenderThread->submit();
+        } else {
+            Profiler::collectGpuTimings();
+            m_Renderer->beginFrame();
+
+            glClearColor(0.1f, 0.1f, 0.12f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            m_Renderer->setModel(green, greenModel);
+            m_Renderer->setOverrideColor(green, dynamicColor);
+
+            m_Renderer->drawAll(*m_Shader, vp);
 
-        glfwSwapBuffers(m_Window->getNativeWindow());
+            if (m_Overlay) {
+                m_Overlay->draw(*m_Renderer, *m_Shader);
+            }
+
+            Window::swapBuffers(m_Window->getNativeWindow());
+        }
         if (m_Input->isKeyPressed(GLFW_KEY_ESCAPE)) {
             glfwSetWindowShouldClose(m_Window->getNativeWindow(), true);
         }
@@ -117,5 +223,34 @@ void Application::mainLoop() {
 		}
 
         m_Input->endFrame();
+        waitForNextRender(nextRender);
+        ++frames;
+    }
+
+    // Nothing was drawn, so this is the engine's own cost per frame
+    if (RenderBackend::active() == BackendKind::Null && frames > 0) {
+        const double seconds = glfwGetTime() - startTime;
+        const RenderBackend::Counts c = RenderBackend::counts();
+        std::printf("Null backend: %d frames, %.4f ms/frame (%.0f fps); per frame %.1f draws, %.1f uniforms, "
+                    "%.1f state changes, %.0f bytes uploaded\n",
+                    frames, seconds * 1000.0 / frames, frames / seconds, (double)c.drawCalls / frames,
+                    (double)c.uniformUploads / frames, (double)c.stateChanges / frames,
+                    (double)c.bytesUploaded / frames);
+    }
+}
+
+void Application::waitForNextRender(double& nextRender) const {
+    if (m_RenderRate <= 0.0) {
+        return;
+    }
+
+    nextRender += 1.0 / m_RenderRate;
+    double wait = nextRender - glfwGetTime();
+
+    if (wait > 0.0) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+    } else {
+        // Running late: restart the schedule rather than rushing to catch up
+        nextRender = glfwGetTime();
     }
 }
\ No newline at end of file
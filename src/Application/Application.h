@@ -4,9 +4,14 @@ class Window;
 class Input;
 class Renderer2D;
 class Shader;
+class RenderThread;
+class ProfilerOverlay;
+class OffscreenTarget;
 
 #include <memory>
 #include <string>
+#include "../core/FixedTimestep.h"
+#include "../core/Window.h"
 
 class Application {
 public:
@@ -18,9 +23,39 @@ public:
 
     void run();
 
+    // Draw on a separate thread from snapshots built by the main loop, so a
+    // frame costs max(update, render) instead of their sum. Set before run().
+    void setRenderThread(bool enabled) { m_UseRenderThread = enabled; }
+
+    // Logic runs in fixed steps of 1/hz seconds (120 by default), at most
+    // maxSteps per rendered frame; rendering interpolates between steps.
+    // A render rate of 0 draws as fast as the display allows (v-sync).
+    void setUpdateRate(double hz) { m_Timestep.setUpdateRate(hz); }
+    void setMaxCatchUpSteps(int maxSteps) { m_Timestep.setMaxSteps(maxSteps); }
+    void setRenderRate(double hz) { m_RenderRate = hz; }
+
+    // Turn the profiler on, draw its overlay (without a render thread) and
+    // write a Chrome trace of the last frames to tracePath on exit
+    void setProfiling(bool enabled, const std::string& tracePath = "sced_trace.json") {
+        m_Profiling = enabled;
+        m_TracePath = tracePath;
+    }
+
+    // Render into an offscreen framebuffer with no window system (CI, batch
+    // jobs); defaults to the SCED_HEADLESS environment variable. Headless
+    // runs stop after the frame limit (1 unless set; 0 = no limit) and save
+    // the last frame to the screenshot path, if any, as PPM.
+    void setHeadless(bool enabled) { m_Mode = enabled ? WindowMode::Headless : WindowMode::Windowed; }
+    // WindowMode::Null also swaps GL for the Null backend (RenderBackend.hpp)
+    // and reports the engine's per-frame cost when the loop ends
+    void setWindowMode(WindowMode mode) { m_Mode = mode; }
+    void setFrameLimit(int frames) { m_FrameLimit = frames; }
+    void setScreenshotPath(const std::string& path) { m_ScreenshotPath = path; }
+
 private:
     void initialize();
     void mainLoop();
+    void waitForNextRender(double& nextRender) const;
     void cleanup();
 
     int m_Width;
@@ -31,4 +66,19 @@ private:
     std::unique_ptr<Input> m_Input;
     std::unique_ptr<Renderer2D> m_Renderer;
     std::unique_ptr<Shader> m_Shader;
+
+    FixedTimestep m_Timestep{120.0, 8};
+    double m_RenderRate = 0.0;
+
+    bool m_Profiling = false;
+    std::string m_TracePath;
+    std::unique_ptr<ProfilerOverlay> m_Overlay;
+
+    WindowMode m_Mode = Window::modeFromEnvironment();
+    int m_FrameLimit = -1;
+    std::string m_ScreenshotPath;
+    std::unique_ptr<OffscreenTarget> m_Offscreen;
+
+    bool m_UseRenderThread = false;
+    std::unique_ptr<RenderThread> m_RenderThread;
 };
\ No newline at end of file
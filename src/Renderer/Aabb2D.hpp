@@ -0,0 +1,57 @@
+#pragma once
+#include <cfloat>
+#include <glm/glm.hpp>
+#include "Vertex2D.hpp"
+
+// Axis-aligned box in 2D. Default constructed it is empty, and expanding
+// an empty box by a point makes it that point.
+struct Aabb2D {
+    glm::vec2 min{FLT_MAX};
+    glm::vec2 max{-FLT_MAX};
+
+    bool empty() const { return min.x > max.x || min.y > max.y; }
+
+    void expand(glm::vec2 p) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+
+    void expand(const Aabb2D& o) {
+        min = glm::min(min, o.min);
+        max = glm::max(max, o.max);
+    }
+
+    // Touching boxes intersect, so shapes exactly on the view edge still draw
+    bool intersects(const Aabb2D& o) const {
+        return min.x <= o.max.x && o.min.x <= max.x &&
+               min.y <= o.max.y && o.min.y <= max.y;
+    }
+
+    bool contains(const Aabb2D& o) const {
+        return min.x <= o.min.x && o.max.x <= max.x &&
+               min.y <= o.min.y && o.max.y <= max.y;
+    }
+
+    // Box around the four transformed corners; stays conservative under rotation
+    Aabb2D transformed(const glm::mat4& m) const {
+        Aabb2D out;
+        if (empty()) return out;
+
+        out.expand(glm::vec2(m * glm::vec4(min.x, min.y, 0.0f, 1.0f)));
+        out.expand(glm::vec2(m * glm::vec4(max.x, min.y, 0.0f, 1.0f)));
+        out.expand(glm::vec2(m * glm::vec4(min.x, max.y, 0.0f, 1.0f)));
+        out.expand(glm::vec2(m * glm::vec4(max.x, max.y, 0.0f, 1.0f)));
+        return out;
+    }
+
+    static Aabb2D of(const Vertex2D* verts, int count) {
+        Aabb2D out;
+        for (int i = 0; i < count; ++i) out.expand(verts[i].pos);
+        return out;
+    }
+
+    // World-space area an orthographic view-projection maps onto clip space
+    static Aabb2D view(const glm::mat4& viewProjection) {
+        return Aabb2D{ glm::vec2(-1.0f), glm::vec2(1.0f) }.transformed(glm::inverse(viewProjection));
+    }
+};
@@ -0,0 +1,158 @@
+#include "Canvas.hpp"
+#include "GLState.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+Canvas::Canvas(int width, int height, glm::vec2 worldMin, glm::vec2 worldMax)
+    : width(width), height(height), worldMin(worldMin), worldMax(worldMax)
+{
+    glGenTextures(1, &colorTex);
+    GLState::bindTexture(GL_TEXTURE_2D, colorTex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLState::bindTexture(GL_TEXTURE_2D, 0);
+
+    GLint previous = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTex, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, previous);
+
+    clear();
+
+    // World-space quad: x, y, u, v as a triangle strip
+    const float quad[16] = {
+        worldMin.x, worldMin.y, 0.0f, 0.0f,
+        worldMax.x, worldMin.y, 1.0f, 0.0f,
+        worldMin.x, worldMax.y, 0.0f, 1.0f,
+        worldMax.x, worldMax.y, 1.0f, 1.0f,
+    };
+
+    glGenVertexArrays(1, &quadVao);
+    glGenBuffers(1, &quadVbo);
+
+    GLState::bindVertexArray(quadVao);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, quadVbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+    GLState::bindVertexArray(0);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+Canvas::~Canvas() {
+    if (quadVao) {
+        GLState::deleteVertexArrays(1, &quadVao);
+    }
+
+    if (quadVbo) {
+        GLState::deleteBuffers(1, &quadVbo);
+    }
+
+    if (fbo) {
+        glDeleteFramebuffers(1, &fbo);
+    }
+
+    if (colorTex) {
+        GLState::deleteTextures(1, &colorTex);
+    }
+}
+
+void Canvas::clear() {
+    GLint previous = 0;
+    GLfloat clearColor[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+    glBindFramebuffer(GL_FRAMEBUFFER, previous);
+
+    baked = 0;
+}
+
+void Canvas::bake(Renderer2D& renderer, const Shader& shader, const std::vector<ShapeHandle>& shapes) {
+    if (shapes.empty()) {
+        return;
+    }
+
+    GLint previous = 0;
+    GLint viewport[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    const GLboolean blend = glIsEnabled(GL_BLEND);
+    GLint srcRgb, dstRgb, srcAlpha, dstAlpha;
+    glGetIntegerv(GL_BLEND_SRC_RGB, &srcRgb);
+    glGetIntegerv(GL_BLEND_DST_RGB, &dstRgb);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &srcAlpha);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &dstAlpha);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, width, height);
+
+    // Accumulate premultiplied color so the texture composites correctly later
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    glm::mat4 proj = glm::ortho(worldMin.x, worldMax.x, worldMin.y, worldMax.y, -1.f, 1.f);
+    renderer.drawShape(shader, proj, shapes);
+    baked += shapes.size();
+
+    if (!blend) glDisable(GL_BLEND);
+    glBlendFuncSeparate(srcRgb, dstRgb, srcAlpha, dstAlpha);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glBindFramebuffer(GL_FRAMEBUFFER, previous);
+}
+
+void Canvas::draw(const Shader& textureShader, const glm::mat4& viewProjection) const {
+    drawQuad(textureShader, viewProjection, false, glm::vec3(1.0f));
+}
+
+void Canvas::draw(const Shader& textureShader, const glm::mat4& viewProjection, const glm::vec3& tint) const {
+    drawQuad(textureShader, viewProjection, true, tint);
+}
+
+void Canvas::drawQuad(const Shader& textureShader, const glm::mat4& viewProjection, bool tinted,
+                      const glm::vec3& tint) const
+{
+    // Nothing baked yet: skip the full-canvas fill
+    if (baked == 0) {
+        return;
+    }
+
+    const GLboolean blend = glIsEnabled(GL_BLEND);
+    GLint srcRgb, dstRgb, srcAlpha, dstAlpha;
+    glGetIntegerv(GL_BLEND_SRC_RGB, &srcRgb);
+    glGetIntegerv(GL_BLEND_DST_RGB, &dstRgb);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &srcAlpha);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &dstAlpha);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    textureShader.useShader();
+    textureShader.setViewProj(viewProjection);
+    textureShader.setUseOverride(tinted);
+    if (tinted) textureShader.setOverride(tint);
+
+    GLState::activeTexture(GL_TEXTURE0);
+    GLState::bindTexture(GL_TEXTURE_2D, colorTex);
+
+    GLState::bindVertexArray(quadVao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    if (!blend) glDisable(GL_BLEND);
+    glBlendFuncSeparate(srcRgb, dstRgb, srcAlpha, dstAlpha);
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Renderer2D.hpp"
+#include "Shader/Shader.hpp"
+
+// Texture that covers a fixed world-space rectangle. Shapes are rendered into
+// it once with bake() and can then be removed from the renderer; drawing the
+// canvas is one textured quad however much has been baked into it.
+// Contents are premultiplied alpha over a transparent background.
+class Canvas {
+public:
+    Canvas(int width, int height, glm::vec2 worldMin, glm::vec2 worldMax);
+    ~Canvas();
+
+    Canvas(const Canvas&) = delete;
+    Canvas& operator=(const Canvas&) = delete;
+
+    // Render shapes on top of what is already in the texture
+    void bake(Renderer2D& renderer, const Shader& shader, const std::vector<ShapeHandle>& shapes);
+    void clear();
+
+    // textureShader is Shader/config/textured.*; the tint variant replaces
+    // the color and keeps the coverage (onion skinning)
+    void draw(const Shader& textureShader, const glm::mat4& viewProjection) const;
+    void draw(const Shader& textureShader, const glm::mat4& viewProjection, const glm::vec3& tint) const;
+
+    GLuint texture() const { return colorTex; }
+    size_t bakedShapes() const { return baked; }
+
+private:
+    GLuint fbo{0}, colorTex{0};
+    GLuint quadVao{0}, quadVbo{0};
+    int width, height;
+    glm::vec2 worldMin, worldMax;
+    size_t baked{0};
+
+    void drawQuad(const Shader& textureShader, const glm::mat4& viewProjection, bool tinted,
+                  const glm::vec3& tint) const;
+};
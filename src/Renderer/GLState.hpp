@@ -0,0 +1,134 @@
+#pragma once
+#include <cstdint>
+#include <glad/glad.h>
+
+struct GLStateCounters {
+    uint32_t bindsIssued = 0;
+    uint32_t bindsElided = 0;
+    uint32_t uniformsIssued = 0;
+    uint32_t uniformsElided = 0;
+};
+
+// Shadow of the bindings the renderer uses, so binding what is already
+// bound costs nothing. Assumes one GL context. Every program/VAO/buffer/
+// texture bind and delete in the renderer goes through here; code that
+// binds them directly must call invalidate() afterwards.
+//
+// GL_ELEMENT_ARRAY_BUFFER is VAO state and is passed straight through.
+class GLState {
+public:
+    static void useProgram(GLuint program) {
+        if (elide(s().program == program)) return;
+        s().program = program;
+        glUseProgram(program);
+    }
+
+    static void bindVertexArray(GLuint vao) {
+        if (elide(s().vao == vao)) return;
+        s().vao = vao;
+        glBindVertexArray(vao);
+    }
+
+    static void bindBuffer(GLenum target, GLuint buffer) {
+        GLuint* slot = bufferSlot(target);
+        if (slot && elide(*slot == buffer)) return;
+        if (slot) *slot = buffer;
+        if (!slot) c().bindsIssued++;
+        glBindBuffer(target, buffer);
+    }
+
+    static void activeTexture(GLenum unit) {
+        if (elide(s().unit == unit - GL_TEXTURE0)) return;
+        s().unit = unit - GL_TEXTURE0;
+        glActiveTexture(unit);
+    }
+
+    // Binds to the active unit
+    static void bindTexture(GLenum target, GLuint texture) {
+        GLuint* slot = textureSlot(target);
+        if (slot && elide(*slot == texture)) return;
+        if (slot) *slot = texture;
+        if (!slot) c().bindsIssued++;
+        glBindTexture(target, texture);
+    }
+
+    // GL unbinds deleted objects; forget them so a recycled name is not
+    // mistaken for the old binding
+    static void deleteBuffers(GLsizei n, const GLuint* ids) {
+        for (GLsizei i = 0; i < n; ++i) {
+            for (GLuint& b : s().buffers) if (b == ids[i]) b = 0;
+        }
+        glDeleteBuffers(n, ids);
+    }
+
+    static void deleteVertexArrays(GLsizei n, const GLuint* ids) {
+        for (GLsizei i = 0; i < n; ++i) {
+            if (s().vao == ids[i]) s().vao = 0;
+        }
+        glDeleteVertexArrays(n, ids);
+    }
+
+    static void deleteTextures(GLsizei n, const GLuint* ids) {
+        for (GLsizei i = 0; i < n; ++i) {
+            for (auto& unit : s().textures) {
+                for (GLuint& t : unit) if (t == ids[i]) t = 0;
+            }
+        }
+        glDeleteTextures(n, ids);
+    }
+
+    // Forget everything; the next bind of each kind is always issued
+    static void invalidate() { s() = State{}; }
+
+    // Uniform caches live in Shader and only report here
+    static void countUniform(bool elided) {
+        if (elided) c().uniformsElided++;
+        else c().uniformsIssued++;
+    }
+
+    static GLStateCounters counters() { return c(); }
+    static void resetCounters() { c() = {}; }
+
+private:
+    static constexpr int units = 16;
+    static constexpr GLuint unknown = 0xFFFFFFFFu;
+
+    struct State {
+        GLuint program = unknown;
+        GLuint vao = unknown;
+        GLuint buffers[4] = { unknown, unknown, unknown, unknown };
+        GLuint unit = unknown;
+        GLuint textures[units][2] = {};
+        State() {
+            for (auto& u : textures) u[0] = u[1] = unknown;
+        }
+    };
+
+    static State& s() { static State state; return state; }
+    static GLStateCounters& c() { static GLStateCounters counters; return counters; }
+
+    static bool elide(bool same) {
+        if (same) c().bindsElided++;
+        else c().bindsIssued++;
+        return same;
+    }
+
+    static GLuint* bufferSlot(GLenum target) {
+        switch (target) {
+            case GL_ARRAY_BUFFER:      return &s().buffers[0];
+            case GL_COPY_READ_BUFFER:  return &s().buffers[1];
+            case GL_COPY_WRITE_BUFFER: return &s().buffers[2];
+            case GL_TEXTURE_BUFFER:    return &s().buffers[3];
+            default:                   return nullptr;
+        }
+    }
+
+    static GLuint* textureSlot(GLenum target) {
+        if (s().unit >= (GLuint)units) return nullptr;
+        switch (target) {
+            case GL_TEXTURE_2D:     return &s().textures[s().unit][0];
+            case GL_TEXTURE_BUFFER: return &s().textures[s().unit][1];
+            default:                return nullptr;
+        }
+    }
+};
@@ -0,0 +1,10 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "Vertex2D.hpp"
+
+// Shared-vertex triangle mesh: every three indices form a triangle
+struct Mesh2D {
+    std::vector<Vertex2D> vertices;
+    std::vector<uint32_t> indices;
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <glm/glm.hpp>
+
+// Identifies parametric geometry so identical shapes can share one cached
+// mesh in Renderer2D. Cached meshes are built around the origin and placed
+// by each instance's model matrix.
+enum class MeshKind : uint8_t {
+    Circle,
+    Ellipse,
+    Rectangle,
+    RegularPolygon,
+    Quad                // centered, size is the half size; used by analytic primitives
+};
+
+struct MeshKey {
+    MeshKind kind = MeshKind::Circle;
+    int segments = 0;           // segments / sides, 0 for rectangles
+    glm::vec2 size{0.0f};       // radii for round shapes, width/height for rectangles, half size for quads
+
+    bool operator==(const MeshKey& o) const {
+        return kind == o.kind && segments == o.segments && size == o.size;
+    }
+};
+
+struct MeshKeyHash {
+    size_t operator()(const MeshKey& k) const {
+        size_t h = std::hash<int>()(static_cast<int>(k.kind));
+        h = h * 31 + std::hash<int>()(k.segments);
+        h = h * 31 + std::hash<float>()(k.size.x);
+        h = h * 31 + std::hash<float>()(k.size.y);
+        return h;
+    }
+};
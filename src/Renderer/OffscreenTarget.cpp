@@ -0,0 +1,80 @@
+#include "OffscreenTarget.hpp"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+OffscreenTarget::OffscreenTarget(int width, int height) : width(width), height(height) {
+    GLint previous = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, previous);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(1, &color);
+        throw std::runtime_error("Offscreen framebuffer incomplete");
+    }
+}
+
+OffscreenTarget::~OffscreenTarget() {
+    if (fbo) {
+        glDeleteFramebuffers(1, &fbo);
+    }
+    if (color) {
+        glDeleteRenderbuffers(1, &color);
+    }
+}
+
+void OffscreenTarget::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, width, height);
+}
+
+void OffscreenTarget::readPixels(std::vector<uint8_t>& out) const {
+    const size_t row = (size_t)width * 4;
+    out.resize(row * height);
+
+    GLint previous = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, out.data());
+    glBindFramebuffer(GL_FRAMEBUFFER, previous);
+
+    // GL rows start at the bottom
+    std::vector<uint8_t> swap(row);
+    for (int y = 0; y < height / 2; ++y) {
+        uint8_t* top = out.data() + y * row;
+        uint8_t* bottom = out.data() + (height - 1 - y) * row;
+        std::memcpy(swap.data(), top, row);
+        std::memcpy(top, bottom, row);
+        std::memcpy(bottom, swap.data(), row);
+    }
+}
+
+bool OffscreenTarget::savePpm(const std::string& path) const {
+    std::vector<uint8_t> pixels;
+    readPixels(pixels);
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        return false;
+    }
+
+    std::fprintf(f, "P6\n%d %d\n255\n", width, height);
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        std::fwrite(&pixels[i], 1, 3, f);
+    }
+
+    return std::fclose(f) == 0;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+
+// Framebuffer object with an RGBA8 color buffer, for rendering without a
+// visible window (see WindowMode::Headless) and reading the result back.
+class OffscreenTarget {
+public:
+    OffscreenTarget(int width, int height);
+    ~OffscreenTarget();
+
+    OffscreenTarget(const OffscreenTarget&) = delete;
+    OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+    // Render into it from now on (framebuffer + viewport)
+    void bind() const;
+
+    // RGBA8, top row first, width * height * 4 bytes
+    void readPixels(std::vector<uint8_t>& out) const;
+    // Binary PPM (RGB), viewable almost anywhere
+    bool savePpm(const std::string& path) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    GLuint id() const { return fbo; }
+
+private:
+    GLuint fbo{0}, color{0};
+    int width, height;
+};
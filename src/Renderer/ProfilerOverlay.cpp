@@ -0,0 +1,102 @@
+#include "ProfilerOverlay.hpp"
+#include "Renderer2D.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+ProfilerOverlay::ProfilerOverlay(glm::vec2 origin, glm::vec2 size)
+    : origin(origin), size(size), frames{} {}
+
+glm::vec3 ProfilerOverlay::colorFor(const char* name) {
+    // FNV-1a over the name, spread over the hue circle
+    uint32_t h = 2166136261u;
+    for (const char* c = name; *c; ++c) {
+        h = (h ^ (unsigned char)*c) * 16777619u;
+    }
+
+    const float hue = (h % 360u) / 60.0f;
+    const float x = 1.0f - std::abs(std::fmod(hue, 2.0f) - 1.0f);
+    const glm::vec3 rgb[6] = { {1, x, 0}, {x, 1, 0}, {0, 1, x}, {0, x, 1}, {x, 0, 1}, {1, 0, x} };
+
+    return 0.35f + 0.65f * rgb[(int)hue % 6];
+}
+
+void ProfilerOverlay::addRect(glm::vec2 min, glm::vec2 max, const glm::vec3& color) {
+    const uint32_t base = (uint32_t)mesh.vertices.size();
+
+    mesh.vertices.push_back({ {min.x, min.y}, color });
+    mesh.vertices.push_back({ {max.x, min.y}, color });
+    mesh.vertices.push_back({ {max.x, max.y}, color });
+    mesh.vertices.push_back({ {min.x, max.y}, color });
+
+    const uint32_t quad[6] = { 0, 1, 2, 0, 2, 3 };
+    for (uint32_t i : quad) mesh.indices.push_back(base + i);
+}
+
+void ProfilerOverlay::addStack(float top, float height, bool gpu) {
+    float x = origin.x;
+
+    for (const auto& total : totals) {
+        if (total.gpu != gpu) {
+            continue;
+        }
+
+        const float width = std::min(total.milliseconds / budgetMs, 1.0) * size.x;
+        const float end = std::min(x + width, origin.x + size.x);
+
+        addRect({x, top - height}, {end, top}, colorFor(total.name));
+        x = end;
+    }
+}
+
+void ProfilerOverlay::draw(Renderer2D& renderer, const Shader& shader) {
+    mesh.vertices.clear();
+    mesh.indices.clear();
+
+    const float graphHeight = size.y * 0.7f;
+    const float barHeight = size.y * 0.12f;
+
+    addRect({origin.x, origin.y - size.y}, {origin.x + size.x, origin.y}, {0.05f, 0.05f, 0.07f});
+
+    // Frame times, newest on the right
+    const int count = Profiler::frameTimes(frames, historyFrames);
+    const float barWidth = size.x / historyFrames;
+    const float graphBottom = origin.y - graphHeight;
+
+    for (int i = 0; i < count; ++i) {
+        const float ms = frames[i];
+        const float x = origin.x + (historyFrames - count + i) * barWidth;
+        const float height = std::min(ms / budgetMs, 1.0f) * graphHeight;
+
+        const glm::vec3 color = ms <= 16.7f ? glm::vec3(0.2f, 0.8f, 0.3f)
+                              : ms <= 33.3f ? glm::vec3(0.9f, 0.8f, 0.2f)
+                                            : glm::vec3(0.9f, 0.25f, 0.2f);
+
+        addRect({x, graphBottom}, {x + barWidth * 0.8f, graphBottom + height}, color);
+    }
+
+    // 60 Hz budget line
+    const float line = graphBottom + (16.7f / budgetMs) * graphHeight;
+    addRect({origin.x, line - 0.002f}, {origin.x + size.x, line + 0.002f}, {0.6f, 0.6f, 0.6f});
+
+    Profiler::lastFrame(totals);
+    addStack(graphBottom - barHeight * 0.25f, barHeight, false);
+    addStack(graphBottom - barHeight * 1.5f, barHeight, true);
+
+    renderer.drawDynamic(shader, glm::mat4(1.0f), mesh);
+}
+
+std::string ProfilerOverlay::summary() {
+    Profiler::lastFrame(totals);
+
+    std::string out;
+    char line[128];
+
+    for (const auto& total : totals) {
+        std::snprintf(line, sizeof(line), "%s%s %s %.2f ms x%u", out.empty() ? "" : ", ",
+                      total.name, total.gpu ? "gpu" : "cpu", total.milliseconds, total.calls);
+        out += line;
+    }
+
+    return out;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Mesh2D.hpp"
+#include "../core/Profiler.h"
+
+class Renderer2D;
+class Shader;
+
+// Profiler data drawn over the scene with Renderer2D, in normalized device
+// coordinates: a graph of recent frame times (green within 60 Hz, yellow
+// within 30 Hz, red beyond) and stacked bars splitting the last frame into
+// its top-level CPU scopes and its GPU passes. There is no text; summary()
+// names the colors.
+class ProfilerOverlay {
+public:
+    // Top-left corner and size, in NDC
+    explicit ProfilerOverlay(glm::vec2 origin = {-0.98f, 0.98f}, glm::vec2 size = {0.9f, 0.35f});
+
+    void draw(Renderer2D& renderer, const Shader& shader);
+
+    // "name cpu 1.23 ms x4, ..." for the last frame, e.g. for a window title
+    std::string summary();
+
+    static glm::vec3 colorFor(const char* name);
+
+private:
+    static constexpr int historyFrames = 120;
+    static constexpr float budgetMs = 33.3f;    // full height / width of the bars
+
+    glm::vec2 origin;
+    glm::vec2 size;
+
+    // Reused every frame
+    Mesh2D mesh;
+    float frames[historyFrames];
+    std::vector<Profiler::ScopeTotal> totals;
+
+    void addRect(glm::vec2 min, glm::vec2 max, const glm::vec3& color);
+    void addStack(float top, float height, bool gpu);
+};
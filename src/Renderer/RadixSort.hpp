@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct SortEntry {
+    uint64_t key;
+    uint32_t value;
+};
+
+// Stable LSD radix sort on the 64-bit keys, one byte per pass. Bytes that
+// are the same in every key (unused layers, no materials) skip their pass,
+// so typical draw lists take two or three passes. scratch is resized as needed.
+inline void radixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch) {
+    const size_t n = entries.size();
+    if (n < 2) return;
+
+    // All eight histograms in one read
+    uint32_t counts[8][256] = {};
+    for (const SortEntry& e : entries) {
+        for (int b = 0; b < 8; ++b) {
+            counts[b][(e.key >> (b * 8)) & 0xFF]++;
+        }
+    }
+
+    scratch.resize(n);
+    std::vector<SortEntry>* src = &entries;
+    std::vector<SortEntry>* dst = &scratch;
+
+    for (int b = 0; b < 8; ++b) {
+        const uint32_t* c = counts[b];
+
+        // One bucket holds everything: this byte does not change the order
+        if (c[((*src)[0].key >> (b * 8)) & 0xFF] == n) {
+            continue;
+        }
+
+        uint32_t offsets[256];
+        uint32_t sum = 0;
+        for (int i = 0; i < 256; ++i) {
+            offsets[i] = sum;
+            sum += c[i];
+        }
+
+        for (const SortEntry& e : *src) {
+            (*dst)[offsets[(e.key >> (b * 8)) & 0xFF]++] = e;
+        }
+
+        std::swap(src, dst);
+    }
+
+    if (src != &entries) {
+        entries.swap(scratch);
+    }
+}
@@ -0,0 +1,491 @@
+#include "RenderBackend.hpp"
+#include <atomic>
+#include <cstring>
+#include <vector>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+namespace {
+    struct Counters {
+        std::atomic<uint64_t> calls{0}, drawCalls{0}, vertices{0}, bufferUploads{0}, bytesUploaded{0},
+                              bufferCopies{0}, bytesCopied{0}, uniformUploads{0}, stateChanges{0}, clears{0};
+    };
+
+    Counters& counters() {
+        static Counters c;
+        return c;
+    }
+
+    void count(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+        counters().calls.fetch_add(1, std::memory_order_relaxed);
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void call() {
+        counters().calls.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void upload(uint64_t bytes) {
+        count(counters().bufferUploads);
+        counters().bytesUploaded.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void state() {
+        count(counters().stateChanges);
+    }
+
+    void draw(uint64_t vertices) {
+        count(counters().drawCalls);
+        counters().vertices.fetch_add(vertices, std::memory_order_relaxed);
+    }
+
+    void uniform() {
+        count(counters().uniformUploads);
+    }
+
+    BackendKind activeKind = BackendKind::OpenGL;
+
+    // Just enough context state for the queries the engine makes. Like a
+    // real context it belongs to one thread at a time.
+    struct NullContext {
+        GLuint nextName = 1;
+        GLint nextUniform = 0;
+        GLint drawFramebuffer = 0, readFramebuffer = 0;
+        GLint viewport[4] = {0, 0, 0, 0};
+        GLfloat clearColor[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        GLint blendSrcRgb = GL_ONE, blendDstRgb = GL_ZERO, blendSrcAlpha = GL_ONE, blendDstAlpha = GL_ZERO;
+        bool blend = false;
+        std::vector<unsigned char> mapped;
+    };
+
+    NullContext& ctx() {
+        static NullContext c;
+        return c;
+    }
+
+    void genNames(GLsizei n, GLuint* names) {
+        call();
+        for (GLsizei i = 0; i < n; ++i) names[i] = ctx().nextName++;
+    }
+
+    void deleteNames(GLsizei, const GLuint*) {
+        call();
+    }
+
+    // --- Null entry points ---
+
+    void APIENTRY nullActiveTexture(GLenum) { state(); }
+    void APIENTRY nullAttachShader(GLuint, GLuint) { call(); }
+    void APIENTRY nullBeginQuery(GLenum, GLuint) { call(); }
+    void APIENTRY nullBindBuffer(GLenum, GLuint) { state(); }
+    void APIENTRY nullBindRenderbuffer(GLenum, GLuint) { state(); }
+    void APIENTRY nullBindTexture(GLenum, GLuint) { state(); }
+    void APIENTRY nullBindVertexArray(GLuint) { state(); }
+
+    void APIENTRY nullBindFramebuffer(GLenum target, GLuint framebuffer) {
+        state();
+        if (target != GL_READ_FRAMEBUFFER) ctx().drawFramebuffer = (GLint)framebuffer;
+        if (target != GL_DRAW_FRAMEBUFFER) ctx().readFramebuffer = (GLint)framebuffer;
+    }
+
+    void APIENTRY nullBlendFunc(GLenum src, GLenum dst) {
+        state();
+        ctx().blendSrcRgb = ctx().blendSrcAlpha = (GLint)src;
+        ctx().blendDstRgb = ctx().blendDstAlpha = (GLint)dst;
+    }
+
+    void APIENTRY nullBlendFuncSeparate(GLenum srcRgb, GLenum dstRgb, GLenum srcAlpha, GLenum dstAlpha) {
+        state();
+        ctx().blendSrcRgb = (GLint)srcRgb;
+        ctx().blendDstRgb = (GLint)dstRgb;
+        ctx().blendSrcAlpha = (GLint)srcAlpha;
+        ctx().blendDstAlpha = (GLint)dstAlpha;
+    }
+
+    void APIENTRY nullBufferData(GLenum, GLsizeiptr size, const void* data, GLenum) {
+        upload(data ? (uint64_t)size : 0);
+    }
+
+    void APIENTRY nullBufferSubData(GLenum, GLintptr, GLsizeiptr size, const void*) {
+        upload((uint64_t)size);
+    }
+
+    // The bytes were already counted when the client wrote the source
+    void APIENTRY nullCopyBufferSubData(GLenum, GLenum, GLintptr, GLintptr, GLsizeiptr size) {
+        count(counters().bufferCopies);
+        counters().bytesCopied.fetch_add((uint64_t)size, std::memory_order_relaxed);
+    }
+
+    void* APIENTRY nullMapBufferRange(GLenum, GLintptr, GLsizeiptr length, GLbitfield) {
+        upload((uint64_t)length);
+        if (ctx().mapped.size() < (size_t)length) ctx().mapped.resize((size_t)length);
+        return ctx().mapped.data();
+    }
+
+    GLboolean APIENTRY nullUnmapBuffer(GLenum) {
+        call();
+        return GL_TRUE;
+    }
+
+    GLenum APIENTRY nullCheckFramebufferStatus(GLenum) {
+        call();
+        return GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    void APIENTRY nullClear(GLbitfield) { count(counters().clears); }
+
+    void APIENTRY nullClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
+        call();
+        ctx().clearColor[0] = r;
+        ctx().clearColor[1] = g;
+        ctx().clearColor[2] = b;
+        ctx().clearColor[3] = a;
+    }
+
+    GLsync APIENTRY nullFenceSync(GLenum, GLbitfield) {
+        call();
+        return reinterpret_cast<GLsync>((uintptr_t)ctx().nextName++);
+    }
+
+    GLenum APIENTRY nullClientWaitSync(GLsync, GLbitfield, GLuint64) {
+        call();
+        return GL_ALREADY_SIGNALED;
+    }
+
+    void APIENTRY nullDeleteSync(GLsync) { call(); }
+
+    void APIENTRY nullCompileShader(GLuint) { call(); }
+    void APIENTRY nullLinkProgram(GLuint) { call(); }
+    void APIENTRY nullShaderSource(GLuint, GLsizei, const GLchar* const*, const GLint*) { call(); }
+    void APIENTRY nullDeleteProgram(GLuint) { call(); }
+    void APIENTRY nullDeleteShader(GLuint) { call(); }
+
+    GLuint APIENTRY nullCreateProgram() {
+        call();
+        return ctx().nextName++;
+    }
+
+    GLuint APIENTRY nullCreateShader(GLenum) {
+        call();
+        return ctx().nextName++;
+    }
+
+    void APIENTRY nullGenBuffers(GLsizei n, GLuint* names) { genNames(n, names); }
+    void APIENTRY nullGenFramebuffers(GLsizei n, GLuint* names) { genNames(n, names); }
+    void APIENTRY nullGenQueries(GLsizei n, GLuint* names) { genNames(n, names); }
+    void APIENTRY nullGenRenderbuffers(GLsizei n, GLuint* names) { genNames(n, names); }
+    void APIENTRY nullGenTextures(GLsizei n, GLuint* names) { genNames(n, names); }
+    void APIENTRY nullGenVertexArrays(GLsizei n, GLuint* names) { genNames(n, names); }
+
+    void APIENTRY nullDeleteBuffers(GLsizei n, const GLuint* names) { deleteNames(n, names); }
+    void APIENTRY nullDeleteFramebuffers(GLsizei n, const GLuint* names) { deleteNames(n, names); }
+    void APIENTRY nullDeleteQueries(GLsizei n, const GLuint* names) { deleteNames(n, names); }
+    void APIENTRY nullDeleteRenderbuffers(GLsizei n, const GLuint* names) { deleteNames(n, names); }
+    void APIENTRY nullDeleteTextures(GLsizei n, const GLuint* names) { deleteNames(n, names); }
+    void APIENTRY nullDeleteVertexArrays(GLsizei n, const GLuint* names) { deleteNames(n, names); }
+
+    void APIENTRY nullEnable(GLenum cap) {
+        state();
+        if (cap == GL_BLEND) ctx().blend = true;
+    }
+
+    void APIENTRY nullDisable(GLenum cap) {
+        state();
+        if (cap == GL_BLEND) ctx().blend = false;
+    }
+
+    GLboolean APIENTRY nullIsEnabled(GLenum cap) {
+        call();
+        return cap == GL_BLEND && ctx().blend ? GL_TRUE : GL_FALSE;
+    }
+
+    void APIENTRY nullEnableVertexAttribArray(GLuint) { state(); }
+    void APIENTRY nullDisableVertexAttribArray(GLuint) { state(); }
+    void APIENTRY nullVertexAttribDivisor(GLuint, GLuint) { state(); }
+    void APIENTRY nullVertexAttribIPointer(GLuint, GLint, GLenum, GLsizei, const void*) { state(); }
+    void APIENTRY nullVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) { state(); }
+
+    void APIENTRY nullDrawArrays(GLenum, GLint, GLsizei count) { draw((uint64_t)count); }
+
+    void APIENTRY nullDrawElementsBaseVertex(GLenum, GLsizei count, GLenum, const void*, GLint) {
+        draw((uint64_t)count);
+    }
+
+    void APIENTRY nullDrawElementsInstancedBaseVertex(GLenum, GLsizei count, GLenum, const void*, GLsizei instances,
+                                                      GLint) {
+        draw((uint64_t)count * (uint64_t)instances);
+    }
+
+    void APIENTRY nullMultiDrawElementsBaseVertex(GLenum, const GLsizei* count, GLenum, const void* const*,
+                                                  GLsizei drawCount, const GLint*) {
+        uint64_t vertices = 0;
+        for (GLsizei i = 0; i < drawCount; ++i) vertices += (uint64_t)count[i];
+        draw(vertices);
+    }
+
+    void APIENTRY nullEndQuery(GLenum) { call(); }
+    void APIENTRY nullFinish() { call(); }
+    void APIENTRY nullFramebufferRenderbuffer(GLenum, GLenum, GLenum, GLuint) { call(); }
+    void APIENTRY nullFramebufferTexture2D(GLenum, GLenum, GLenum, GLuint, GLint) { call(); }
+    void APIENTRY nullPixelStorei(GLenum, GLint) { call(); }
+    void APIENTRY nullReadPixels(GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, void*) { call(); }
+    void APIENTRY nullRenderbufferStorage(GLenum, GLenum, GLsizei, GLsizei) { call(); }
+    void APIENTRY nullTexBuffer(GLenum, GLenum, GLuint) { call(); }
+    void APIENTRY nullTexParameteri(GLenum, GLenum, GLint) { call(); }
+
+    void APIENTRY nullTexImage2D(GLenum, GLint, GLint, GLsizei width, GLsizei height, GLint, GLenum, GLenum,
+                                 const void* data) {
+        if (data) {
+            upload((uint64_t)width * (uint64_t)height * 4);
+        } else {
+            call();
+        }
+    }
+
+    void APIENTRY nullGetFloatv(GLenum name, GLfloat* out) {
+        call();
+        if (name == GL_COLOR_CLEAR_VALUE) {
+            std::memcpy(out, ctx().clearColor, sizeof(ctx().clearColor));
+        } else {
+            out[0] = 0.0f;
+        }
+    }
+
+    void APIENTRY nullGetIntegerv(GLenum name, GLint* out) {
+        call();
+        switch (name) {
+            case GL_VIEWPORT: std::memcpy(out, ctx().viewport, sizeof(ctx().viewport)); break;
+            case GL_DRAW_FRAMEBUFFER_BINDING: *out = ctx().drawFramebuffer; break;
+            case GL_READ_FRAMEBUFFER_BINDING: *out = ctx().readFramebuffer; break;
+            case GL_BLEND_SRC_RGB: *out = ctx().blendSrcRgb; break;
+            case GL_BLEND_DST_RGB: *out = ctx().blendDstRgb; break;
+            case GL_BLEND_SRC_ALPHA: *out = ctx().blendSrcAlpha; break;
+            case GL_BLEND_DST_ALPHA: *out = ctx().blendDstAlpha; break;
+            case GL_MAX_TEXTURE_BUFFER_SIZE: *out = 1 << 27; break;
+            case GL_NUM_EXTENSIONS: *out = 1; break;
+            case GL_MAJOR_VERSION: *out = 3; break;
+            case GL_MINOR_VERSION: *out = 3; break;
+            default: *out = 0; break;
+        }
+    }
+
+    void APIENTRY nullGetProgramiv(GLuint, GLenum name, GLint* out) {
+        call();
+        *out = name == GL_LINK_STATUS ? GL_TRUE : 0;
+    }
+
+    void APIENTRY nullGetShaderiv(GLuint, GLenum name, GLint* out) {
+        call();
+        *out = name == GL_COMPILE_STATUS ? GL_TRUE : 0;
+    }
+
+    void APIENTRY nullGetProgramInfoLog(GLuint, GLsizei size, GLsizei* length, GLchar* log) {
+        call();
+        if (length) *length = 0;
+        if (size > 0) log[0] = '\0';
+    }
+
+    void APIENTRY nullGetShaderInfoLog(GLuint, GLsizei size, GLsizei* length, GLchar* log) {
+        call();
+        if (length) *length = 0;
+        if (size > 0) log[0] = '\0';
+    }
+
+    void APIENTRY nullGetQueryObjectiv(GLuint, GLenum name, GLint* out) {
+        call();
+        *out = name == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+    }
+
+    void APIENTRY nullGetQueryObjectui64v(GLuint, GLenum, GLuint64* out) {
+        call();
+        *out = 0;
+    }
+
+    const GLubyte* APIENTRY nullGetString(GLenum name) {
+        call();
+        switch (name) {
+            case GL_VENDOR: return (const GLubyte*)"SCEd";
+            case GL_RENDERER: return (const GLubyte*)"Null backend";
+            case GL_VERSION: return (const GLubyte*)"3.3 (Null backend)";
+            case GL_SHADING_LANGUAGE_VERSION: return (const GLubyte*)"3.30";
+            default: return (const GLubyte*)"";
+        }
+    }
+
+    const GLubyte* APIENTRY nullGetStringi(GLenum, GLuint) {
+        call();
+        return (const GLubyte*)"GL_SCED_null_backend";
+    }
+
+    GLint APIENTRY nullGetUniformLocation(GLuint, const GLchar*) {
+        call();
+        return ctx().nextUniform++;
+    }
+
+    void APIENTRY nullUniform1i(GLint, GLint) { uniform(); }
+    void APIENTRY nullUniform3fv(GLint, GLsizei, const GLfloat*) { uniform(); }
+    void APIENTRY nullUniform4fv(GLint, GLsizei, const GLfloat*) { uniform(); }
+    void APIENTRY nullUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat*) { uniform(); }
+    void APIENTRY nullUseProgram(GLuint) { state(); }
+
+    void APIENTRY nullViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+        state();
+        ctx().viewport[0] = x;
+        ctx().viewport[1] = y;
+        ctx().viewport[2] = width;
+        ctx().viewport[3] = height;
+    }
+
+    struct Entry {
+        const char* name;
+        void* proc;
+    };
+
+    // The cast checks each stub against GLAD's pointer type for that entry point
+#define SCED_NULL_ENTRY(name, stub) { #name, (void*)static_cast<decltype(glad_##name)>(&stub) }
+
+    const Entry nullEntries[] = {
+        SCED_NULL_ENTRY(glActiveTexture, nullActiveTexture),
+        SCED_NULL_ENTRY(glAttachShader, nullAttachShader),
+        SCED_NULL_ENTRY(glBeginQuery, nullBeginQuery),
+        SCED_NULL_ENTRY(glBindBuffer, nullBindBuffer),
+        SCED_NULL_ENTRY(glBindFramebuffer, nullBindFramebuffer),
+        SCED_NULL_ENTRY(glBindRenderbuffer, nullBindRenderbuffer),
+        SCED_NULL_ENTRY(glBindTexture, nullBindTexture),
+        SCED_NULL_ENTRY(glBindVertexArray, nullBindVertexArray),
+        SCED_NULL_ENTRY(glBlendFunc, nullBlendFunc),
+        SCED_NULL_ENTRY(glBlendFuncSeparate, nullBlendFuncSeparate),
+        SCED_NULL_ENTRY(glBufferData, nullBufferData),
+        SCED_NULL_ENTRY(glBufferSubData, nullBufferSubData),
+        SCED_NULL_ENTRY(glCheckFramebufferStatus, nullCheckFramebufferStatus),
+        SCED_NULL_ENTRY(glClear, nullClear),
+        SCED_NULL_ENTRY(glClearColor, nullClearColor),
+        SCED_NULL_ENTRY(glClientWaitSync, nullClientWaitSync),
+        SCED_NULL_ENTRY(glCompileShader, nullCompileShader),
+        SCED_NULL_ENTRY(glCopyBufferSubData, nullCopyBufferSubData),
+        SCED_NULL_ENTRY(glCreateProgram, nullCreateProgram),
+        SCED_NULL_ENTRY(glCreateShader, nullCreateShader),
+        SCED_NULL_ENTRY(glDeleteBuffers, nullDeleteBuffers),
+        SCED_NULL_ENTRY(glDeleteFramebuffers, nullDeleteFramebuffers),
+        SCED_NULL_ENTRY(glDeleteProgram, nullDeleteProgram),
+        SCED_NULL_ENTRY(glDeleteQueries, nullDeleteQueries),
+        SCED_NULL_ENTRY(glDeleteRenderbuffers, nullDeleteRenderbuffers),
+        SCED_NULL_ENTRY(glDeleteShader, nullDeleteShader),
+        SCED_NULL_ENTRY(glDeleteSync, nullDeleteSync),
+        SCED_NULL_ENTRY(glDeleteTextures, nullDeleteTextures),
+        SCED_NULL_ENTRY(glDeleteVertexArrays, nullDeleteVertexArrays),
+        SCED_NULL_ENTRY(glDisable, nullDisable),
+        SCED_NULL_ENTRY(glDisableVertexAttribArray, nullDisableVertexAttribArray),
+        SCED_NULL_ENTRY(glDrawArrays, nullDrawArrays),
+        SCED_NULL_ENTRY(glDrawElementsBaseVertex, nullDrawElementsBaseVertex),
+        SCED_NULL_ENTRY(glDrawElementsInstancedBaseVertex, nullDrawElementsInstancedBaseVertex),
+        SCED_NULL_ENTRY(glEnable, nullEnable),
+        SCED_NULL_ENTRY(glEnableVertexAttribArray, nullEnableVertexAttribArray),
+        SCED_NULL_ENTRY(glEndQuery, nullEndQuery),
+        SCED_NULL_ENTRY(glFenceSync, nullFenceSync),
+        SCED_NULL_ENTRY(glFinish, nullFinish),
+        SCED_NULL_ENTRY(glFramebufferRenderbuffer, nullFramebufferRenderbuffer),
+        SCED_NULL_ENTRY(glFramebufferTexture2D, nullFramebufferTexture2D),
+        SCED_NULL_ENTRY(glGenBuffers, nullGenBuffers),
+        SCED_NULL_ENTRY(glGenFramebuffers, nullGenFramebuffers),
+        SCED_NULL_ENTRY(glGenQueries, nullGenQueries),
+        SCED_NULL_ENTRY(glGenRenderbuffers, nullGenRenderbuffers),
+        SCED_NULL_ENTRY(glGenTextures, nullGenTextures),
+        SCED_NULL_ENTRY(glGenVertexArrays, nullGenVertexArrays),
+        SCED_NULL_ENTRY(glGetFloatv, nullGetFloatv),
+        SCED_NULL_ENTRY(glGetIntegerv, nullGetIntegerv),
+        SCED_NULL_ENTRY(glGetProgramInfoLog, nullGetProgramInfoLog),
+        SCED_NULL_ENTRY(glGetProgramiv, nullGetProgramiv),
+        SCED_NULL_ENTRY(glGetQueryObjectiv, nullGetQueryObjectiv),
+        SCED_NULL_ENTRY(glGetQueryObjectui64v, nullGetQueryObjectui64v),
+        SCED_NULL_ENTRY(glGetShaderInfoLog, nullGetShaderInfoLog),
+        SCED_NULL_ENTRY(glGetShaderiv, nullGetShaderiv),
+        SCED_NULL_ENTRY(glGetString, nullGetString),
+        SCED_NULL_ENTRY(glGetStringi, nullGetStringi),
+        SCED_NULL_ENTRY(glGetUniformLocation, nullGetUniformLocation),
+        SCED_NULL_ENTRY(glIsEnabled, nullIsEnabled),
+        SCED_NULL_ENTRY(glLinkProgram, nullLinkProgram),
+        SCED_NULL_ENTRY(glMapBufferRange, nullMapBufferRange),
+        SCED_NULL_ENTRY(glMultiDrawElementsBaseVertex, nullMultiDrawElementsBaseVertex),
+        SCED_NULL_ENTRY(glPixelStorei, nullPixelStorei),
+        SCED_NULL_ENTRY(glReadPixels, nullReadPixels),
+        SCED_NULL_ENTRY(glRenderbufferStorage, nullRenderbufferStorage),
+        SCED_NULL_ENTRY(glShaderSource, nullShaderSource),
+        SCED_NULL_ENTRY(glTexBuffer, nullTexBuffer),
+        SCED_NULL_ENTRY(glTexImage2D, nullTexImage2D),
+        SCED_NULL_ENTRY(glTexParameteri, nullTexParameteri),
+        SCED_NULL_ENTRY(glUniform1i, nullUniform1i),
+        SCED_NULL_ENTRY(glUniform3fv, nullUniform3fv),
+        SCED_NULL_ENTRY(glUniform4fv, nullUniform4fv),
+        SCED_NULL_ENTRY(glUniformMatrix4fv, nullUniformMatrix4fv),
+        SCED_NULL_ENTRY(glUnmapBuffer, nullUnmapBuffer),
+        SCED_NULL_ENTRY(glUseProgram, nullUseProgram),
+        SCED_NULL_ENTRY(glVertexAttribDivisor, nullVertexAttribDivisor),
+        SCED_NULL_ENTRY(glVertexAttribIPointer, nullVertexAttribIPointer),
+        SCED_NULL_ENTRY(glVertexAttribPointer, nullVertexAttribPointer),
+        SCED_NULL_ENTRY(glViewport, nullViewport),
+    };
+
+#undef SCED_NULL_ENTRY
+
+    // Entry points the engine never calls stay null, as on a driver without
+    // them; optional features (program binaries) check before use
+    void* nullProcAddress(const char* name) {
+        for (const Entry& entry : nullEntries) {
+            if (std::strcmp(entry.name, name) == 0) return entry.proc;
+        }
+        return nullptr;
+    }
+}
+
+namespace RenderBackend {
+    bool load(BackendKind kind) {
+        const int loaded = kind == BackendKind::Null ? gladLoadGLLoader((GLADloadproc)nullProcAddress)
+                                                     : gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+        if (!loaded) {
+            return false;
+        }
+
+        activeKind = kind;
+        resetCounts();
+        return true;
+    }
+
+    BackendKind active() {
+        return activeKind;
+    }
+
+    void release() {
+        gladLoadGLLoader((GLADloadproc)nullProcAddress);
+    }
+
+    Counts counts() {
+        Counters& c = counters();
+        Counts out;
+        out.calls = c.calls.load(std::memory_order_relaxed);
+        out.drawCalls = c.drawCalls.load(std::memory_order_relaxed);
+        out.vertices = c.vertices.load(std::memory_order_relaxed);
+        out.bufferUploads = c.bufferUploads.load(std::memory_order_relaxed);
+        out.bytesUploaded = c.bytesUploaded.load(std::memory_order_relaxed);
+        out.bufferCopies = c.bufferCopies.load(std::memory_order_relaxed);
+        out.bytesCopied = c.bytesCopied.load(std::memory_order_relaxed);
+        out.uniformUploads = c.uniformUploads.load(std::memory_order_relaxed);
+        out.stateChanges = c.stateChanges.load(std::memory_order_relaxed);
+        out.clears = c.clears.load(std::memory_order_relaxed);
+        return out;
+    }
+
+    void resetCounts() {
+        Counters& c = counters();
+        c.calls.store(0, std::memory_order_relaxed);
+        c.drawCalls.store(0, std::memory_order_relaxed);
+        c.vertices.store(0, std::memory_order_relaxed);
+        c.bufferUploads.store(0, std::memory_order_relaxed);
+        c.bytesUploaded.store(0, std::memory_order_relaxed);
+        c.bufferCopies.store(0, std::memory_order_relaxed);
+        c.bytesCopied.store(0, std::memory_order_relaxed);
+        c.uniformUploads.store(0, std::memory_order_relaxed);
+        c.stateChanges.store(0, std::memory_order_relaxed);
+        c.clears.store(0, std::memory_order_relaxed);
+    }
+}
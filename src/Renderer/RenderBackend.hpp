@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include "../core/Window.h"
+
+// Where the engine's GL calls end up. Every GL call (Renderer2D, Shader,
+// GLState, StreamBuffer, Canvas, the apps' own clears) goes through GLAD's
+// entry points, so those are the backend interface:
+//
+//   OpenGL  entry points from the current context
+//   Null    stubs that count commands and draw nothing; no context, driver
+//           or GPU needed. Queries answer like a complete GL 3.3 context
+//           (names are unique, shaders compile, framebuffers are complete,
+//           fences are signaled, maps return scratch memory).
+//
+// With Null, a frame costs only the engine's own CPU work, so scenes run at
+// thousands of frames per second and profiles show engine hot paths alone.
+enum class BackendKind {
+    OpenGL,
+    Null
+};
+
+namespace RenderBackend {
+    // Load the entry points; OpenGL needs a current context
+    bool load(BackendKind kind);
+    BackendKind active();
+    // Call before the context goes away: GL objects still in scope then
+    // delete themselves into the Null stubs instead of a dead context
+    void release();
+
+    // Null windows have no context and use the Null backend
+    inline BackendKind forMode(WindowMode mode) {
+        return mode == WindowMode::Null ? BackendKind::Null : BackendKind::OpenGL;
+    }
+
+    // Commands the Null backend has received since the last reset
+    struct Counts {
+        uint64_t calls = 0;             // every GL entry point
+        uint64_t drawCalls = 0;
+        uint64_t vertices = 0;          // vertices/indices submitted, times instances
+        uint64_t bufferUploads = 0;     // buffer data/sub data/map, texture images
+        uint64_t bytesUploaded = 0;     // written by the client; a mapped range counts once
+        uint64_t bufferCopies = 0;      // GPU-side glCopyBufferSubData, not in the two above
+        uint64_t bytesCopied = 0;
+        uint64_t uniformUploads = 0;
+        uint64_t stateChanges = 0;      // binds, enables, blend, viewport
+        uint64_t clears = 0;
+    };
+
+    Counts counts();
+    void resetCounts();
+}
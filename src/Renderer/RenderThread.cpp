@@ -0,0 +1,126 @@
+#include "RenderThread.hpp"
+#include "Renderer2D.hpp"
+#include "Shader/Shader.hpp"
+#include "../core/Profiler.h"
+#include "../core/Window.h"
+#include <chrono>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+RenderThread::RenderThread(GLFWwindow* window, Renderer2D& renderer, const Shader& shader)
+    : window(window), hasContext(glfwGetWindowAttrib(window, GLFW_CLIENT_API) != GLFW_NO_API),
+      renderer(renderer), shader(shader)
+{
+    // A context can only be current on one thread at a time
+    glfwMakeContextCurrent(nullptr);
+    thread = std::thread(&RenderThread::run, this);
+}
+
+RenderThread::~RenderThread() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    thread.join();
+
+    if (hasContext) {
+        glfwMakeContextCurrent(window);
+    }
+}
+
+RenderSnapshot& RenderThread::beginFrame() {
+    RenderSnapshot& frame = snapshots[back];
+    frame.updates.clear();
+    frame.drawList.clear();
+    return frame;
+}
+
+void RenderThread::submit() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // Wait for the previous frame; this is the only point the two threads meet
+    wake.wait(lock, [this] { return !pending || error; });
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    pending = true;
+    back ^= 1;
+    lock.unlock();
+
+    wake.notify_all();
+}
+
+void RenderThread::run() {
+    if (hasContext) {
+        glfwMakeContextCurrent(window);
+    }
+    Profiler::setThreadName("Render");
+
+    while (true) {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [this] { return pending || stopping; });
+
+        if (!pending) {
+            break;
+        }
+
+        const RenderSnapshot& frame = snapshots[back ^ 1];
+        lock.unlock();
+
+        try {
+            render(frame);
+        } catch (...) {
+            lock.lock();
+            error = std::current_exception();
+            pending = false;
+            lock.unlock();
+            wake.notify_all();
+            break;
+        }
+
+        lock.lock();
+        pending = false;
+        lock.unlock();
+        wake.notify_all();
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
+
+void RenderThread::render(const RenderSnapshot& frame) {
+    SCED_PROFILE_SCOPE("RenderThread::render");
+    const auto start = std::chrono::steady_clock::now();
+
+    Profiler::collectGpuTimings();
+    renderer.beginFrame();
+
+    for (const RenderSnapshot::Update& u : frame.updates) {
+        switch (u.kind) {
+            case RenderSnapshot::Update::Model:         renderer.setModel(u.handle, u.model); break;
+            case RenderSnapshot::Update::Override:      renderer.setOverrideColor(u.handle, u.color); break;
+            case RenderSnapshot::Update::ClearOverride: renderer.clearOverrideColor(u.handle); break;
+        }
+    }
+
+    if (frame.framebufferSize.x > 0 && frame.framebufferSize.y > 0) {
+        glViewport(0, 0, frame.framebufferSize.x, frame.framebufferSize.y);
+    }
+
+    glClearColor(frame.clearColor.r, frame.clearColor.g, frame.clearColor.b, frame.clearColor.a);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (frame.drawList.empty()) {
+        renderer.drawAll(shader, frame.viewProjection);
+    } else {
+        renderer.drawShape(shader, frame.viewProjection, frame.drawList);
+    }
+
+    Window::swapBuffers(window);
+
+    renderMs.store(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count(),
+                   std::memory_order_relaxed);
+    frames.fetch_add(1, std::memory_order_relaxed);
+}
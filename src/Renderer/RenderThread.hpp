@@ -0,0 +1,94 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <glm/glm.hpp>
+#include "ShapeHandle.hpp"
+
+struct GLFWwindow;
+class Renderer2D;
+class Shader;
+
+// Everything the render thread needs for one frame. Filled by the
+// simulation, then left alone once submitted.
+struct RenderSnapshot {
+    struct Update {
+        enum Kind : uint8_t { Model, Override, ClearOverride };
+
+        ShapeHandle handle;
+        Kind kind;
+        glm::mat4 model;
+        glm::vec3 color;
+    };
+
+    std::vector<Update> updates;            // applied in order before drawing
+    std::vector<ShapeHandle> drawList;      // drawShape() selection; empty draws everything
+    glm::mat4 viewProjection{1.0f};
+    glm::vec4 clearColor{0.0f, 0.0f, 0.0f, 1.0f};
+    glm::ivec2 framebufferSize{0, 0};
+
+    void setModel(ShapeHandle handle, const glm::mat4& model) {
+        updates.push_back({handle, Update::Model, model, glm::vec3(0.0f)});
+    }
+
+    void setOverrideColor(ShapeHandle handle, const glm::vec3& color) {
+        updates.push_back({handle, Update::Override, glm::mat4(1.0f), color});
+    }
+
+    void clearOverrideColor(ShapeHandle handle) {
+        updates.push_back({handle, Update::ClearOverride, glm::mat4(1.0f), glm::vec3(0.0f)});
+    }
+};
+
+// Owns the window's GL context on a thread of its own and draws submitted
+// snapshots, so the caller can simulate frame N+1 while frame N renders.
+// Two snapshots alternate: submit() only waits for the previous frame to be
+// finished, never for the one being filled.
+//
+// While it runs the renderer and shader belong to the render thread; the
+// caller may still create shapes through renderer.staging(), which is
+// committed at the start of every rendered frame. Construct it on the
+// thread whose context is current; the context is handed back on destruction.
+class RenderThread {
+public:
+    RenderThread(GLFWwindow* window, Renderer2D& renderer, const Shader& shader);
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // The snapshot to fill for the next frame, emptied of last time's updates
+    RenderSnapshot& beginFrame();
+    // Hand it over; rethrows anything the render thread threw
+    void submit();
+
+    // Milliseconds the last frame spent on the render thread (draw + swap)
+    float renderMilliseconds() const { return renderMs.load(std::memory_order_relaxed); }
+    uint64_t framesRendered() const { return frames.load(std::memory_order_relaxed); }
+
+private:
+    GLFWwindow* window;
+    bool hasContext;            // false for WindowMode::Null windows
+    Renderer2D& renderer;
+    const Shader& shader;
+
+    RenderSnapshot snapshots[2];
+    int back{0};                // filled by the caller; the other one is the render thread's
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool pending{false};        // snapshots[back ^ 1] is submitted and not finished yet
+    bool stopping{false};
+    std::exception_ptr error;
+
+    std::atomic<float> renderMs{0.0f};
+    std::atomic<uint64_t> frames{0};
+
+    std::thread thread;
+
+    void run();
+    void render(const RenderSnapshot& frame);
+};
@@ -1,40 +1,150 @@
 #include "Renderer2D.hpp"
+#include "GLState.hpp"
+#include "../core/Profiler.h"
 #include "../Renderer/Transform.hpp"
 #include <cstddef>
+#include "Shapes.hpp"
+
+namespace {
+    // Allocator owners with this bit set are mesh slots, not shape slots
+    constexpr uint32_t meshOwner = 0x80000000u;
+
+    // Shape data per slot: 4 model columns, override color + flag, sdf params
+    constexpr size_t shapeTexels = 6;
+
+    Mesh2D buildCachedMesh(const MeshKey& key) {
+        const glm::vec3 white(1.0f);
+
+        switch (key.kind) {
+            case MeshKind::Circle:
+                return Shapes::makeCircleMesh({0, 0}, key.size.x, key.segments, white);
+            case MeshKind::Ellipse:
+                return Shapes::makeEllipseMesh({0, 0}, key.size, key.segments, white);
+            case MeshKind::Rectangle:
+                return Shapes::makeRectangleMesh({0, 0}, key.size, white);
+            case MeshKind::RegularPolygon:
+                return Shapes::makeRegularPolygonMesh({0, 0}, key.size.x, key.segments, white);
+            case MeshKind::Quad:
+                return Shapes::makeRectangleMesh(-key.size, key.size, white);
+        }
+
+        return {};
+    }
+}
 
 Renderer2D::Renderer2D() {
     glGenVertexArrays(1, &vao);
     glGenBuffers(1, &vbo);
 
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    GLState::bindVertexArray(vao);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, vbo);
     glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(
-        0, 2, GL_FLOAT, GL_FALSE,
-        sizeof(Vertex2D),
-        (void*)offsetof(Vertex2D, pos)
-    );
+    // Position/color attributes for the compile-time vertex format
+    GpuVertexLayout::setupAttributes();
+
+    // Shape index per vertex, only read by the batched path
+    glGenBuffers(1, &indexVbo);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, indexVbo);
+    glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribIPointer(2, 1, GL_UNSIGNED_INT, sizeof(uint32_t), (void*)0);
+
+    // Element buffer binding is VAO state
+    glGenBuffers(1, &ebo);
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
 
+    GLState::bindVertexArray(0);
+
+    // Instanced runs read the shape index once per instance from a draw list's
+    // slot buffer; the pointer is set per run
+    glGenVertexArrays(1, &instanceVao);
+    GLState::bindVertexArray(instanceVao);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, vbo);
+    GpuVertexLayout::setupAttributes();
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    GLState::bindVertexArray(0);
+
+    glGenBuffers(1, &drawList.slotBuffer);
+    glGenBuffers(1, &batchList.slotBuffer);
+    glGenBuffers(1, &cullList.slotBuffer);
+
+    // Per-shape models and override colors for the batched path
+    glGenBuffers(1, &shapeDataBuffer);
+    GLState::bindBuffer(GL_TEXTURE_BUFFER, shapeDataBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
+
+    glGenTextures(1, &shapeDataTex);
+    GLState::bindTexture(GL_TEXTURE_BUFFER, shapeDataTex);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, shapeDataBuffer);
+    GLState::bindTexture(GL_TEXTURE_BUFFER, 0);
+    GLState::bindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxShapeDataTexels);
+
+    // Dynamic geometry is drawn straight out of the streaming ring
+    glGenVertexArrays(1, &dynamicVao);
+    GLState::bindVertexArray(dynamicVao);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, stream.id());
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2D), (void*)offsetof(Vertex2D, pos));
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(
-        1, 3, GL_FLOAT, GL_FALSE,
-        sizeof(Vertex2D),
-        (void*)offsetof(Vertex2D, color)
-    );
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex2D), (void*)offsetof(Vertex2D, color));
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, stream.id());
 
-    glBindVertexArray(0);
+    GLState::bindVertexArray(0);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 
 Renderer2D::~Renderer2D() {
     if (vao) {
-        glDeleteVertexArrays(1, &vao);
+        GLState::deleteVertexArrays(1, &vao);
+    }
+
+    if (dynamicVao) {
+        GLState::deleteVertexArrays(1, &dynamicVao);
+    }
+
+    if (instanceVao) {
+        GLState::deleteVertexArrays(1, &instanceVao);
+    }
+
+    if (drawList.slotBuffer) {
+        GLState::deleteBuffers(1, &drawList.slotBuffer);
+    }
+
+    if (batchList.slotBuffer) {
+        GLState::deleteBuffers(1, &batchList.slotBuffer);
+    }
+
+    if (cullList.slotBuffer) {
+        GLState::deleteBuffers(1, &cullList.slotBuffer);
     }
 
     if (vbo) {
-        glDeleteBuffers(1, &vbo);
+        GLState::deleteBuffers(1, &vbo);
+    }
+
+    if (indexVbo) {
+        GLState::deleteBuffers(1, &indexVbo);
+    }
+
+    if (ebo) {
+        GLState::deleteBuffers(1, &ebo);
+    }
+
+    if (shapeDataTex) {
+        GLState::deleteTextures(1, &shapeDataTex);
+    }
+
+    if (shapeDataBuffer) {
+        GLState::deleteBuffers(1, &shapeDataBuffer);
     }
 }
 
@@ -44,168 +154,1135 @@ ShapeHandle Renderer2D::addShape(const Vertex2D* verts, int count, const glm::ma
         return {};
     }
 
-    // The current size of verts in cpu, mark where the new shape will be inserted
-    const int start = static_cast<int>(cpu.size());
+    // Plain triangle list: every vertex is its own index
+    std::vector<uint32_t> indices(count);
+    for (int i = 0; i < count; ++i) indices[i] = (uint32_t)i;
 
-    // Insert the verts into the end of the cpu vertex
-    cpu.insert(cpu.end(), verts, verts + count);
+    return addShape(verts, count, indices.data(), count, model);
+}
 
-    // The GPU needs to be updated
-    dirty = true;
+ShapeHandle Renderer2D::addShape(const Mesh2D& mesh, const glm::mat4& model) {
+    return addShape(mesh.vertices.data(), (int)mesh.vertices.size(),
+                    mesh.indices.data(), (int)mesh.indices.size(), model);
+}
+
+ShapeHandle Renderer2D::addShape(const Vertex2D* verts, int count, const uint32_t* indices, int indexCount,
+                                 const glm::mat4& model)
+{
+    return insertShape({}, verts, count, indices, indexCount, model);
+}
 
-    // Create the return record
+ShapeHandle Renderer2D::insertShape(ShapeHandle reserved, const Vertex2D* verts, int count, const uint32_t* indices,
+                                    int indexCount, const glm::mat4& model)
+{
+    if (count <= 0 || indexCount <= 0) {
+        return {};
+    }
+
+    // Create the record; the slot map hands back a slot index + generation
     ShapeRecord record{};
+    record.count = count;
+    record.indexCount = indexCount;
+    record.model = model;
+    record.color = verts[0].color;
+    record.flatColor = GpuVertexLayout::perShapeColor;
+    record.depth = frontDepth++;
+
+    ShapeHandle handle = reserved;
+    if (!reserved.valid()) {
+        handle = shapes.insert(record);
+    } else if (!shapes.insertAt(reserved, record)) {
+        return {};
+    }
 
-    // Give it the next unique id
-    record.id = nextID++;
     // Where the shape lives on the GPU
-    record.offset = start;
-    // 
-    record.count = count;
+    ShapeRecord& r = shapes.at(handle.index);
+    storeGeometry(handle.index, verts, count, indices, indexCount, r.offset, r.indexOffset);
+
+    r.localBounds = Aabb2D::of(verts, count);
+    updateBounds(handle.index);
+
+    writeShapeData(handle.index);
+    drawListDirty = true;
+
+    return handle;
+}
+
+void Renderer2D::storeGeometry(uint32_t owner, const Vertex2D* verts, int count, const uint32_t* indices,
+                               int indexCount, int& offset, int& indexOffset)
+{
+    // Reuse freed ranges if they fit, otherwise grow at the end
+    offset = allocator.allocate(count, owner);
+    if (allocator.top() > (int)cpu.size()) {
+        resizeCpu(allocator.top());
+    }
+
+    indexOffset = indexAllocator.allocate(indexCount, owner);
+    if (indexAllocator.top() > (int)cpuIndices.size()) {
+        cpuIndices.resize(indexAllocator.top());
+    }
+
+    // Mesh vertices are only drawn instanced, so their shape index is unused
+    const uint32_t slot = (owner & meshOwner) ? 0 : owner;
+
+    std::transform(verts, verts + count, cpu.begin() + offset, GpuVertexLayout::pack);
+    std::fill(cpuShapeIndex.begin() + offset, cpuShapeIndex.begin() + offset + count, slot);
+
+    // Indices stay relative to the first vertex; it is passed as the base vertex
+    std::copy(indices, indices + indexCount, cpuIndices.begin() + indexOffset);
+
+    // Only the new ranges need to go to the GPU
+    markDirty(offset, count);
+    markIndicesDirty(indexOffset, indexCount);
+}
+
+MeshHandle Renderer2D::addMesh(const Mesh2D& mesh) {
+    if (mesh.vertices.empty() || mesh.indices.empty()) {
+        return {};
+    }
+
+    MeshRecord record;
+    record.count = (int)mesh.vertices.size();
+    record.indexCount = (int)mesh.indices.size();
+    record.refs = 1;
+    record.localBounds = Aabb2D::of(mesh.vertices.data(), record.count);
+
+    MeshHandle handle = meshes.insert(record);
+
+    MeshRecord& m = meshes.at(handle.index);
+    storeGeometry(meshOwner | handle.index, mesh.vertices.data(), m.count, mesh.indices.data(), m.indexCount,
+                  m.offset, m.indexOffset);
+
+    return handle;
+}
+
+MeshHandle Renderer2D::getCachedMesh(const MeshKey& key) {
+    auto it = meshCache.find(key);
+    if (it != meshCache.end()) {
+        return it->second;
+    }
+
+    // The cache keeps the reference addMesh hands out
+    MeshHandle handle = addMesh(buildCachedMesh(key));
+    if (handle.valid()) {
+        meshCache[key] = handle;
+    }
+
+    return handle;
+}
+
+void Renderer2D::releaseMesh(MeshHandle mesh) {
+    if (meshes.contains(mesh)) {
+        releaseMeshSlot(mesh.index);
+    }
+}
+
+void Renderer2D::clearMeshCache() {
+    for (auto& [key, mesh] : meshCache) {
+        releaseMesh(mesh);
+    }
+
+    meshCache.clear();
+}
+
+void Renderer2D::releaseMeshSlot(uint32_t slot) {
+    MeshRecord& m = meshes.at(slot);
+
+    if (--m.refs > 0) {
+        return;
+    }
+
+    allocator.free(m.offset);
+    resizeCpu(allocator.top());
+
+    indexAllocator.free(m.indexOffset);
+    cpuIndices.resize(indexAllocator.top());
+
+    meshes.remove(meshes.handleAt(slot));
+}
+
+ShapeHandle Renderer2D::addInstance(MeshHandle mesh, const glm::mat4& model, const glm::vec3& color) {
+    MeshRecord* m = meshes.get(mesh);
+
+    if (!m) {
+        stats.staleHandles++;
+        return {};
+    }
+
+    m->refs++;
+
+    // Offsets stay with the mesh, which compaction may move
+    ShapeRecord record{};
+    record.count = m->count;
+    record.indexCount = m->indexCount;
     record.model = model;
-    shapes.push_back(record);
+    record.color = color;
+    record.flatColor = true;
+    record.mesh = mesh.index;
+    record.localBounds = m->localBounds;
+    record.depth = frontDepth++;
+
+    ShapeHandle handle = shapes.insert(record);
+    updateBounds(handle.index);
+
+    writeShapeData(handle.index);
+    drawListDirty = true;
 
-    return ShapeHandle{record.id};
+    return handle;
 }
 
-/*
-ShapeHandle Renderer2D::addShapeFront(const Vertex2D* verts, int count, const glm::mat4& model) {
-    if (count <= 0) {
+ShapeHandle Renderer2D::addPrimitive(const SdfPrimitive& prim, const glm::mat4& model, const glm::vec3& color) {
+    if (prim.kind == SdfKind::None) {
         return {};
     }
 
-    // The current size of verts in cpu, mark where the new shape will be inserted
-    const int start = static_cast<int>(cpu.size());
+    // Every primitive of one size shares a quad
+    ShapeHandle handle = addInstance(getCachedMesh({ MeshKind::Quad, 0, prim.halfSize }), model, color);
+    if (!handle.valid()) {
+        return handle;
+    }
+
+    shapes.at(handle.index).sdf = glm::vec4(prim.halfSize, prim.cornerRadius, (float)prim.kind);
+    writeShapeData(handle.index);
+
+    return handle;
 }
-*/
 
-void Renderer2D::setModel(ShapeHandle handle, const glm::mat4& matrix) {
-    if (auto* r = find(handle)) r->model = matrix;
+ShapeHandle Renderer2D::cloneShape(ShapeHandle source, const glm::mat4& model) {
+    ShapeRecord* r = find(source);
+
+    if (!r) {
+        return {};
+    }
+
+    // First clone: the source's ranges become a mesh that it references
+    if (r->mesh == UINT32_MAX) {
+        MeshRecord record;
+        record.offset = r->offset;
+        record.count = r->count;
+        record.indexOffset = r->indexOffset;
+        record.indexCount = r->indexCount;
+        record.refs = 1;
+        record.localBounds = r->localBounds;
+
+        MeshHandle mesh = meshes.insert(record);
+        allocator.setOwner(r->offset, meshOwner | mesh.index);
+        indexAllocator.setOwner(r->indexOffset, meshOwner | mesh.index);
+
+        r->mesh = mesh.index;
+        drawListDirty = true;
+    }
+
+    const ShapeRecord src = *r;
+    meshes.at(src.mesh).refs++;
+
+    ShapeRecord record = src;
+    record.model = model;
+    record.useOverride = false;
+    record.proxy = SpatialIndex::null;
+    record.boundsStale = false;     // updateBounds below covers the new model
+    record.depth = frontDepth++;
+
+    ShapeHandle handle = shapes.insert(record);
+    updateBounds(handle.index);
+
+    writeShapeData(handle.index);
+    drawListDirty = true;
+
+    return handle;
 }
 
-void Renderer2D::setOverrideColor(ShapeHandle handle, const glm::vec3& color) {
-    if (auto* r = find(handle)) { r->useOverride = true; r->overrideColor = color; }
+bool Renderer2D::setModel(ShapeHandle handle, const glm::mat4& matrix) {
+    auto* r = find(handle);
+    if (!r) return false;
+
+    r->model = matrix;
+
+    if (!r->boundsStale) {
+        r->boundsStale = true;
+        staleBounds.push_back(handle);
+    }
+    return true;
 }
 
-void Renderer2D::clearOverrideColor(ShapeHandle handle) {
-    if (auto* r = find(handle)) r->useOverride = false;
+bool Renderer2D::setOverrideColor(ShapeHandle handle, const glm::vec3& color) {
+    auto* r = find(handle);
+    if (!r) return false;
+
+    r->useOverride = true;
+    r->overrideColor = color;
+    writeShapeData(handle.index);
+    return true;
 }
 
-void Renderer2D::updateVertices(ShapeHandle handle, const Vertex2D* verts, int count) {
+bool Renderer2D::clearOverrideColor(ShapeHandle handle) {
+    auto* r = find(handle);
+    if (!r) return false;
+
+    r->useOverride = false;
+    writeShapeData(handle.index);
+    return true;
+}
+
+bool Renderer2D::updateVertices(ShapeHandle handle, const Vertex2D* verts, int count) {
     auto* record = find(handle);
 
     if (!record || count != record->count) {
-        return;
+        return false;
     }
 
-    for (int i = 0; i < count; ++i) {
-        cpu[record->offset + i] = verts[i];
-        dirty = true;
+    if (record->mesh != UINT32_MAX) {
+        // Shared geometry belongs to every other user of the mesh: copy on
+        // write, into ranges of this shape's own with the mesh's indices
+        const MeshRecord& m = meshes.at(record->mesh);
+        const std::vector<uint32_t> indices(cpuIndices.begin() + m.indexOffset,
+                                            cpuIndices.begin() + m.indexOffset + m.indexCount);
+        const uint32_t mesh = record->mesh;
+
+        storeGeometry(handle.index, verts, count, indices.data(), (int)indices.size(),
+                      record->offset, record->indexOffset);
+
+        record->mesh = UINT32_MAX;
+        releaseMeshSlot(mesh);
+        drawListDirty = true;
+    } else {
+        for (int i = 0; i < count; ++i) {
+            cpu[record->offset + i] = GpuVertexLayout::pack(verts[i]);
+        }
+
+        markDirty(record->offset, count);
     }
+
+    record->localBounds = Aabb2D::of(verts, count);
+    updateBounds(handle.index);
+
+    record->color = verts[0].color;
+    if (record->flatColor) {
+        writeShapeData(handle.index);
+    }
+
+    return true;
 }
 
 void Renderer2D::drawAll(const Shader& shader, const glm::mat4& viewProj) {
-    if (dirty) {
+    SCED_PROFILE_SCOPE("Renderer2D::drawAll");
+    SCED_PROFILE_GPU("drawAll");
+
+    flushBounds();
+
+    if (!dirtyRanges.empty() || !indexDirtyRanges.empty()) {
         upload();
     }
 
+    const Aabb2D view = Aabb2D::view(viewProj);
+
+    // Only re-sorted after shapes or their draw order changed
+    if (drawListDirty) {
+        rebuildDrawList();
+        cullDirty = true;
+    } else if (drawListOffsetsDirty) {
+        patchOffsets(drawList);
+        if (!cullDirty) patchOffsets(cullList);
+        drawListOffsetsDirty = false;
+    }
+
+    if (renderPath == RenderPath::Batched && canBatch()) {
+        bindBatch(shader, viewProj);
+
+        if (!culling) {
+            // Every live shape in draw order, skipping freed holes; one call
+            // unless shared meshes break it into instanced runs
+            drawBatch(drawList);
+            return;
+        }
+
+        // Same runs over the visible shapes; a still camera over a still
+        // scene reuses last frame's list and slot buffer
+        if (cullDirty || view.min != cullView.min || view.max != cullView.max) {
+            rebuildCullList(view);
+        }
+
+        stats.shapesCulled += cullListCulled;
+        drawBatch(cullList);
+        return;
+    }
+
     shader.useShader();
     shader.setViewProj(viewProj);
+    shader.setUseBatch(false);
+
+    GLState::bindVertexArray(vao);
 
-    
-    glBindVertexArray(vao);
-    for (const auto& r : shapes) {
-        shader.setModel(r.model);
-        shader.setUseOverride(r.useOverride);
-        if (r.useOverride) shader.setOverride(r.overrideColor);
-        glDrawArrays(GL_TRIANGLES, r.offset, r.count);
+    for (uint32_t slot : drawOrder) {
+        const ShapeRecord& r = shapes.at(slot);
+
+        if (culling && !r.bounds.intersects(view)) {
+            stats.shapesCulled++;
+            continue;
+        }
+
+        setShapeUniforms(shader, r);
+        glDrawElementsBaseVertex(GL_TRIANGLES, r.indexCount, GL_UNSIGNED_INT,
+                                 (const void*)((size_t)indexOffsetOf(r) * sizeof(uint32_t)), vertexOffsetOf(r));
+
+        stats.drawCalls++;
+        stats.vertices += (uint64_t)r.indexCount;
+        stats.shapesDrawn++;
     }
 
-    glBindVertexArray(0);
 }
 
 void Renderer2D::upload() {
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER,
-                 (GLsizeiptr)(cpu.size() * sizeof(Vertex2D)),
-                 cpu.data(),
-                 GL_DYNAMIC_DRAW);
-    dirty = false;
+    SCED_PROFILE_SCOPE("Renderer2D::upload");
+
+    const int vertexCount = (int)cpu.size();
+    const int indexCount = (int)cpuIndices.size();
+
+    // Grow geometrically; a fresh store needs everything re-sent
+    if (vertexCount > gpuCapacity) {
+        gpuCapacity = std::max({vertexCount, gpuCapacity * 2, 1024});
+
+        GLState::bindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)gpuCapacity * sizeof(GpuVertex), nullptr, GL_DYNAMIC_DRAW);
+        GLState::bindBuffer(GL_ARRAY_BUFFER, indexVbo);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)gpuCapacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+        stats.bufferUploads += 2;
+
+        dirtyRanges.assign(1, {0, vertexCount});
+    }
+
+    if (indexCount > gpuIndexCapacity) {
+        gpuIndexCapacity = std::max({indexCount, gpuIndexCapacity * 2, 1024});
+
+        GLState::bindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+        glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)gpuIndexCapacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+        stats.bufferUploads++;
+
+        indexDirtyRanges.assign(1, {0, indexCount});
+    }
+
+    // Vertex data plus the slot index for every vertex, read by the batched path
+    auto vertexRanges = dirtyRanges;
+    uploadRanges(dirtyRanges, vertexCount, vbo, cpu.data(), sizeof(GpuVertex));
+    uploadRanges(vertexRanges, vertexCount, indexVbo, cpuShapeIndex.data(), sizeof(uint32_t));
+    uploadRanges(indexDirtyRanges, indexCount, ebo, cpuIndices.data(), sizeof(uint32_t));
 }
 
-ShapeRecord* Renderer2D::find(ShapeHandle h) {
-    for (auto& r : shapes) {
-        if (r.id == h.id) {
-            return &r;
+void Renderer2D::uploadRanges(std::vector<std::pair<int, int>>& ranges, int limit,
+                              GLuint target, const void* data, size_t stride)
+{
+    // Sort and merge spans that touch or sit close together
+    std::sort(ranges.begin(), ranges.end());
+
+    const int mergeGap = 64;
+    std::vector<std::pair<int, int>> merged;
+    for (const auto& range : ranges) {
+        if (!merged.empty() && range.first <= merged.back().second + mergeGap) {
+            merged.back().second = std::max(merged.back().second, range.second);
+        } else {
+            merged.push_back(range);
         }
     }
-    return nullptr;
+
+    const char* bytes = static_cast<const char*>(data);
+
+    for (auto range : merged) {
+        // Spans past the top belong to shapes that were freed since
+        range.second = std::min(range.second, limit);
+        if (range.first >= range.second) continue;
+
+        uploadSpan(target,
+                   (GLintptr)(range.first * stride),
+                   (GLsizeiptr)((range.second - range.first) * stride),
+                   bytes + range.first * stride);
+    }
+
+    ranges.clear();
+}
+
+void Renderer2D::uploadSpan(GLuint target, GLintptr offset, GLsizeiptr bytes, const void* data) {
+    // Stage through the ring and let the GPU copy it in order, so the CPU
+    // never waits for draws still reading the destination buffer
+    GLintptr staged = stream.write(data, (size_t)bytes);
+
+    if (staged >= 0) {
+        GLState::bindBuffer(GL_COPY_READ_BUFFER, stream.id());
+        GLState::bindBuffer(GL_COPY_WRITE_BUFFER, target);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, staged, offset, bytes);
+    } else {
+        // Larger than a ring segment: hand it to the driver directly
+        GLState::bindBuffer(GL_COPY_WRITE_BUFFER, target);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, offset, bytes, data);
+    }
+
+    stats.bytesUploaded += (uint64_t)bytes;
+    stats.bufferUploads++;
+}
+
+void Renderer2D::markDirty(int offset, int count) {
+    dirtyRanges.push_back({offset, offset + count});
+}
+
+void Renderer2D::markIndicesDirty(int offset, int count) {
+    indexDirtyRanges.push_back({offset, offset + count});
+}
+
+void Renderer2D::resizeCpu(int vertices) {
+    cpu.resize(vertices);
+    cpuShapeIndex.resize(vertices);
+}
+
+void Renderer2D::writeShapeData(uint32_t slot) {
+    // Indexed by slot; free slots keep stale data that no vertex references
+    if (shapeData.size() < shapes.capacity() * shapeTexels) {
+        shapeData.resize(shapes.capacity() * shapeTexels);
+    }
+
+    const ShapeRecord& r = shapes.at(slot);
+    glm::vec4* texels = &shapeData[(size_t)slot * shapeTexels];
+
+    texels[0] = r.model[0];
+    texels[1] = r.model[1];
+    texels[2] = r.model[2];
+    texels[3] = r.model[3];
+
+    // Flat-colored shapes (instances, formats without a color attribute)
+    // always take the override path
+    if (r.flatColor && !r.useOverride) {
+        texels[4] = glm::vec4(r.color, 1.0f);
+    } else {
+        texels[4] = glm::vec4(r.overrideColor, r.useOverride ? 1.0f : 0.0f);
+    }
+
+    texels[5] = r.sdf;
+
+    shapeDirtyBegin = std::min(shapeDirtyBegin, slot);
+    shapeDirtyEnd   = std::max(shapeDirtyEnd, slot + 1);
+}
+
+void Renderer2D::uploadShapeData() {
+    GLState::bindBuffer(GL_TEXTURE_BUFFER, shapeDataBuffer);
+
+    if (shapeData.size() > shapeDataCapacity) {
+        shapeDataCapacity = std::max(shapeData.size(), shapeDataCapacity * 2);
+
+        glBufferData(GL_TEXTURE_BUFFER, (GLsizeiptr)(shapeDataCapacity * sizeof(glm::vec4)), nullptr, GL_DYNAMIC_DRAW);
+        stats.bufferUploads++;
+
+        shapeDirtyBegin = 0;
+        shapeDirtyEnd = (uint32_t)(shapeData.size() / shapeTexels);
+    }
+
+
+    const size_t first = (size_t)shapeDirtyBegin * shapeTexels;
+    const size_t count = (size_t)(shapeDirtyEnd - shapeDirtyBegin) * shapeTexels;
+
+    uploadSpan(shapeDataBuffer,
+               (GLintptr)(first * sizeof(glm::vec4)),
+               (GLsizeiptr)(count * sizeof(glm::vec4)),
+               shapeData.data() + first);
+
+    shapeDirtyBegin = UINT32_MAX;
+    shapeDirtyEnd = 0;
+}
+
+void Renderer2D::DrawList::clear() {
+    counts.clear();
+    indices.clear();
+    baseVertices.clear();
+    multiDrawSlots.clear();
+    instanceSlots.clear();
+    runs.clear();
+    multiDrawIndices = 0;
+    slotsDirty = true;
+}
+
+void Renderer2D::DrawList::add(uint32_t slot, const ShapeRecord& r) {
+    // Start a new run whenever the kind of draw changes, to keep draw order
+    if (runs.empty() || runs.back().mesh != r.mesh) {
+        const int first = (int)(r.mesh == UINT32_MAX ? counts.size() : instanceSlots.size());
+        runs.push_back({r.mesh, first, 0});
+    }
+
+    runs.back().count++;
+
+    if (r.mesh == UINT32_MAX) {
+        counts.push_back(r.indexCount);
+        multiDrawIndices += (uint64_t)r.indexCount;
+        indices.push_back((const void*)((size_t)r.indexOffset * sizeof(uint32_t)));
+        baseVertices.push_back(r.offset);
+        multiDrawSlots.push_back(slot);
+    } else {
+        instanceSlots.push_back(slot);
+    }
+}
+
+void Renderer2D::drawBatch(DrawList& list) {
+    if (list.slotsDirty && !list.instanceSlots.empty()) {
+        const size_t bytes = list.instanceSlots.size() * sizeof(uint32_t);
+
+        GLState::bindBuffer(GL_ARRAY_BUFFER, list.slotBuffer);
+        if (bytes > list.slotCapacity) {
+            list.slotCapacity = std::max(bytes, list.slotCapacity * 2);
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)list.slotCapacity, nullptr, GL_DYNAMIC_DRAW);
+        }
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)bytes, list.instanceSlots.data());
+
+        stats.bytesUploaded += bytes;
+        stats.bufferUploads++;
+    }
+
+    list.slotsDirty = false;
+
+    for (const auto& run : list.runs) {
+        if (run.mesh == UINT32_MAX) {
+            GLState::bindVertexArray(vao);
+            glMultiDrawElementsBaseVertex(GL_TRIANGLES, list.counts.data() + run.first, GL_UNSIGNED_INT,
+                                          list.indices.data() + run.first, (GLsizei)run.count,
+                                          list.baseVertices.data() + run.first);
+        } else {
+            const MeshRecord& m = meshes.at(run.mesh);
+
+            GLState::bindVertexArray(instanceVao);
+            GLState::bindBuffer(GL_ARRAY_BUFFER, list.slotBuffer);
+            glVertexAttribIPointer(2, 1, GL_UNSIGNED_INT, sizeof(uint32_t),
+                                   (void*)((size_t)run.first * sizeof(uint32_t)));
+
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, m.indexCount, GL_UNSIGNED_INT,
+                                              (const void*)((size_t)m.indexOffset * sizeof(uint32_t)),
+                                              (GLsizei)run.count, m.offset);
+            stats.vertices += (uint64_t)m.indexCount * (uint64_t)run.count;
+        }
+
+        stats.drawCalls++;
+    }
+
+    stats.vertices += list.multiDrawIndices;
+    stats.shapesDrawn += (uint32_t)list.size();
+}
+
+uint64_t Renderer2D::sortKey(const ShapeRecord& r) {
+    // layer | depth | material. The material is the mesh, so instances of one
+    // mesh at equal layer and depth end up next to each other in one run.
+    const uint64_t layer = (uint16_t)(r.layer ^ INT16_MIN);
+    const uint64_t material = r.mesh == UINT32_MAX ? 0 : std::min<uint32_t>(r.mesh + 1, 0xFFFF);
+
+    return (layer << 48) | ((uint64_t)r.depth << 16) | material;
+}
+
+void Renderer2D::sortSlots(std::vector<SortEntry>& entries) {
+    radixSort(entries, sortScratch);
+}
+
+void Renderer2D::rebuildDrawList() {
+    sortEntries.clear();
+
+    shapes.forEach([&](uint32_t slot, const ShapeRecord& r) {
+        sortEntries.push_back({ sortKey(r), slot });
+    });
+
+    sortSlots(sortEntries);
+    stats.drawListSorts++;
+
+    drawOrder.clear();
+    drawList.clear();
+
+    for (const SortEntry& e : sortEntries) {
+        drawOrder.push_back(e.value);
+        drawList.add(e.value, shapes.at(e.value));
+    }
+
+    drawListDirty = false;
+    drawListOffsetsDirty = false;
+}
+
+void Renderer2D::patchOffsets(DrawList& list) {
+    // Instanced runs read their mesh's offsets at draw time; only the
+    // multi-draw arguments hold copies
+    for (size_t i = 0; i < list.multiDrawSlots.size(); ++i) {
+        const ShapeRecord& r = shapes.at(list.multiDrawSlots[i]);
+        list.indices[i] = (const void*)((size_t)r.indexOffset * sizeof(uint32_t));
+        list.baseVertices[i] = r.offset;
+    }
+}
+
+const std::vector<uint32_t>& Renderer2D::getDrawOrder() {
+    flushBounds();
+
+    if (drawListDirty) {
+        rebuildDrawList();
+        cullDirty = true;
+    }
+
+    return drawOrder;
+}
+
+void Renderer2D::rebuildCullList(const Aabb2D& view) {
+    cullList.clear();
+    cullListCulled = 0;
+
+    for (uint32_t slot : drawOrder) {
+        const ShapeRecord& r = shapes.at(slot);
+
+        if (r.bounds.intersects(view)) {
+            cullList.add(slot, r);
+        } else {
+            cullListCulled++;
+        }
+    }
+
+    cullView = view;
+    cullDirty = false;
+}
+
+void Renderer2D::updateBounds(uint32_t slot) {
+    ShapeRecord& r = shapes.at(slot);
+    r.bounds = r.localBounds.transformed(r.model);
+
+    if (r.proxy == SpatialIndex::null) {
+        r.proxy = spatial.insert(slot, r.bounds);
+    } else {
+        spatial.move(r.proxy, r.bounds);
+    }
+
+    cullDirty = true;
+}
+
+void Renderer2D::flushBounds() {
+    for (ShapeHandle handle : staleBounds) {
+        ShapeRecord* r = shapes.get(handle);
+
+        if (!r || !r->boundsStale) {
+            continue;
+        }
+
+        r->boundsStale = false;
+        updateBounds(handle.index);
+        writeShapeData(handle.index);
+    }
+
+    staleBounds.clear();
+}
+
+bool Renderer2D::canBatch() const {
+    // Fall back to per-shape draws if the scene outgrows the texture buffer
+    if (maxShapeDataTexels <= 0) {
+        return false;
+    }
+
+    return shapes.capacity() * shapeTexels <= (size_t)maxShapeDataTexels;
+}
+
+void Renderer2D::bindBatch(const Shader& shader, const glm::mat4& viewProj) {
+    if (shapeDirtyBegin < shapeDirtyEnd) {
+        uploadShapeData();
+    }
+
+    shader.useShader();
+    shader.setViewProj(viewProj);
+    shader.setUseBatch(true);
+    shader.setShapeDataUnit(0);
+
+    GLState::activeTexture(GL_TEXTURE0);
+    GLState::bindTexture(GL_TEXTURE_BUFFER, shapeDataTex);
+
+    GLState::bindVertexArray(vao);
+}
+
+void Renderer2D::setShapeUniforms(const Shader& shader, const ShapeRecord& r) {
+    shader.setModel(r.model);
+    shader.setSdf(r.sdf);
+
+    if (r.flatColor) {
+        shader.setUseOverride(true);
+        shader.setOverride(r.useOverride ? r.overrideColor : r.color);
+        return;
+    }
+
+    shader.setUseOverride(r.useOverride);
+    if (r.useOverride) shader.setOverride(r.overrideColor);
+}
+
+ShapeRecord* Renderer2D::find(ShapeHandle h) {
+    ShapeRecord* r = shapes.get(h);
+
+    if (!r) {
+        stats.staleHandles++;
+    }
+
+    return r;
 }
 
 void Renderer2D::drawShape(const Shader& shader,
                            const glm::mat4& viewProjection,
-                           const std::vector<ShapeHandle>& selection)
+                           const std::vector<ShapeHandle>& selection,
+                           const Aabb2D* selectionBounds)
 {
-    upload();
+    SCED_PROFILE_SCOPE("Renderer2D::drawShape");
+    SCED_PROFILE_GPU("drawShape");
 
-    shader.useShader();
-    shader.setViewProj(viewProjection);
+    flushBounds();
 
-    glBindVertexArray(vao);
+    const Aabb2D view = Aabb2D::view(viewProjection);
 
-    for (auto& handle : selection)
-    {
+    // Whole selection off screen: no per-shape work at all
+    if (culling && selectionBounds && !selectionBounds->intersects(view)) {
+        stats.shapesCulled += (uint32_t)selection.size();
+        return;
+    }
+
+    if (!dirtyRanges.empty() || !indexDirtyRanges.empty()) {
+        upload();
+    }
+
+    // Visible shapes of the selection, in draw order whatever order they came in
+    sortEntries.clear();
+
+    for (auto& handle : selection) {
         auto* r = find(handle);
 
         if (!r) {
             continue;
         }
 
-        shader.setModel(r->model);
-        shader.setUseOverride(r->useOverride);
+        if (culling && !r->bounds.intersects(view)) {
+            stats.shapesCulled++;
+            continue;
+        }
+
+        sortEntries.push_back({ sortKey(*r), handle.index });
+    }
+
+    if (sortEntries.empty()) {
+        return;
+    }
+
+    sortSlots(sortEntries);
+
+    if (renderPath == RenderPath::Batched && canBatch()) {
+        batchList.clear();
 
-        if (r->useOverride) {
-            shader.setOverride(r->overrideColor);
+        for (const SortEntry& e : sortEntries) {
+            batchList.add(e.value, shapes.at(e.value));
         }
 
-        glDrawArrays(GL_TRIANGLES, r->offset, r->count);
+        bindBatch(shader, viewProjection);
+
+        // Whole selection in as few calls as draw order allows, each range
+        // or instance still picks its own shape data
+        drawBatch(batchList);
+        return;
+    }
+
+    shader.useShader();
+    shader.setViewProj(viewProjection);
+    shader.setUseBatch(false);
+
+    GLState::bindVertexArray(vao);
+
+    for (const SortEntry& e : sortEntries)
+    {
+        const ShapeRecord& r = shapes.at(e.value);
+
+        setShapeUniforms(shader, r);
+
+        glDrawElementsBaseVertex(GL_TRIANGLES, r.indexCount, GL_UNSIGNED_INT,
+                                 (const void*)((size_t)indexOffsetOf(r) * sizeof(uint32_t)), vertexOffsetOf(r));
+
+        stats.drawCalls++;
+        stats.vertices += (uint64_t)r.indexCount;
+        stats.shapesDrawn++;
     }
 
-    glBindVertexArray(0);
 }
 
-void Renderer2D::setPosition(ShapeHandle handle, glm::vec2 position) {
+bool Renderer2D::setPosition(ShapeHandle handle, glm::vec2 position) {
     glm::mat4 model = Transform::translate(Transform::setIdentity(), position);
-    setModel(handle, model);
+    return setModel(handle, model);
+}
+
+bool Renderer2D::setLayer(ShapeHandle handle, int layer) {
+    auto* r = find(handle);
+    if (!r) return false;
+
+    r->layer = (int16_t)std::clamp(layer, INT16_MIN, INT16_MAX);
+    drawListDirty = true;
+    return true;
+}
+
+bool Renderer2D::setDepth(ShapeHandle handle, uint32_t depth) {
+    auto* r = find(handle);
+    if (!r) return false;
+
+    r->depth = depth;
+    drawListDirty = true;
+    return true;
+}
+
+bool Renderer2D::bringToFront(ShapeHandle handle) {
+    return setDepth(handle, frontDepth++);
+}
+
+bool Renderer2D::sendToBack(ShapeHandle handle) {
+    return setDepth(handle, --backDepth);
+}
+
+bool Renderer2D::removeShape(ShapeHandle handle) {
+    auto* record = find(handle);
+
+    if (!record) return false;
+
+    // Hand the range back; no other shape moves and nothing is re-uploaded
+    if (record->mesh != UINT32_MAX) {
+        releaseMeshSlot(record->mesh);
+    } else {
+        allocator.free(record->offset);
+        resizeCpu(allocator.top());
+
+        indexAllocator.free(record->indexOffset);
+        cpuIndices.resize(indexAllocator.top());
+    }
+
+    spatial.remove(record->proxy);
+
+    // Free the slot, bumping its generation
+    shapes.remove(handle);
+
+    drawListDirty = true;
+    return true;
+}
+
+int Renderer2D::commitStaged() {
+    int added = 0;
+    std::vector<uint32_t> sequence;
+
+    for (StagingQueue::Block* block : stagingQueue.takeAll()) {
+        for (const StagingQueue::Command& c : block->commands) {
+            if (c.vertexCount == 0) {
+                setModel(c.handle, c.model);
+                continue;
+            }
+
+            const Vertex2D* verts = block->vertices.data() + c.vertexOffset;
+            const uint32_t* indices = block->indices.data() + c.indexOffset;
+            int indexCount = c.indexCount;
+
+            // Plain triangle list: every vertex is its own index
+            if (indexCount == 0) {
+                if ((int)sequence.size() < c.vertexCount) {
+                    for (uint32_t i = (uint32_t)sequence.size(); i < (uint32_t)c.vertexCount; ++i) sequence.push_back(i);
+                }
+                indices = sequence.data();
+                indexCount = c.vertexCount;
+            }
+
+            if (insertShape(c.handle, verts, c.vertexCount, indices, indexCount, c.model).valid()) {
+                ++added;
+            }
+        }
+
+        delete block;
+    }
+
+    stats.shapesStaged += (uint32_t)added;
+    return added;
+}
+
+void Renderer2D::beginFrame() {
+    stats = {};
+    GLState::resetCounters();
+
+    commitStaged();
+
+    stream.resetCounters();
+    stream.nextFrame();
+
+    if (compactionBudget > 0) {
+        compact(compactionBudget);
+    }
+}
+
+int Renderer2D::compact(int maxElements) {
+    int moved = allocator.compact(maxElements, [&](uint32_t owner, int from, int to, int count) {
+        // Moving down, so a forward copy is safe even when the ranges overlap
+        std::copy(cpu.begin() + from, cpu.begin() + from + count, cpu.begin() + to);
+        std::copy(cpuShapeIndex.begin() + from, cpuShapeIndex.begin() + from + count, cpuShapeIndex.begin() + to);
+        markDirty(to, count);
+
+        if (owner & meshOwner) {
+            meshes.at(owner & ~meshOwner).offset = to;
+        } else {
+            shapes.at(owner).offset = to;
+        }
+    });
+
+    // Offsets changed, sort keys did not: the draw lists are patched, not re-sorted
+    if (moved > 0) {
+        resizeCpu(allocator.top());
+        drawListOffsetsDirty = true;
+    }
+
+    // Indices are relative to the base vertex, so they move as-is
+    int movedIndices = indexAllocator.compact(maxElements, [&](uint32_t owner, int from, int to, int count) {
+        std::copy(cpuIndices.begin() + from, cpuIndices.begin() + from + count, cpuIndices.begin() + to);
+        markIndicesDirty(to, count);
+
+        if (owner & meshOwner) {
+            meshes.at(owner & ~meshOwner).indexOffset = to;
+        } else {
+            shapes.at(owner).indexOffset = to;
+        }
+    });
+
+    if (movedIndices > 0) {
+        cpuIndices.resize(indexAllocator.top());
+        drawListOffsetsDirty = true;
+    }
+
+    return moved + movedIndices;
 }
 
-void Renderer2D::removeShape(ShapeHandle handle) {
-    auto it = std::find_if(shapes.begin(), shapes.end(),
-        [&](const ShapeRecord& r) { return r.id == handle.id; });
+RenderStats Renderer2D::getStats() const {
+    RenderStats s = stats;
+
+    // Counted by the state cache, shared by everything on this context
+    const GLStateCounters gl = GLState::counters();
+    s.uniformUploads = gl.uniformsIssued;
+    s.stateChanges = gl.bindsIssued;
+    s.elidedCalls = gl.bindsElided + gl.uniformsElided;
+
+    s.bytesStreamed = stream.bytesStreamed();
+    s.fenceWaits = stream.fenceWaits();
+    return s;
+}
+
+void Renderer2D::drawDynamic(const Shader& shader, const glm::mat4& viewProjection,
+                             const Vertex2D* verts, int count, const glm::mat4& model)
+{
+    if (count <= 0) {
+        return;
+    }
 
-    if (it == shapes.end()) return;
+    // Vertex-aligned so the offset can be used as the first vertex
+    GLintptr offset = stream.write(verts, (size_t)count * sizeof(Vertex2D), sizeof(Vertex2D));
+    if (offset < 0) {
+        return;
+    }
 
-    int removeOffset = it->offset;
-    int removeCount  = it->count;
+    shader.useShader();
+    shader.setViewProj(viewProjection);
+    shader.setUseBatch(false);
+    shader.setModel(model);
+    shader.setUseOverride(false);
+    shader.setSdf(glm::vec4(0.0f));
 
-    // Erase vertices from CPU buffer
-    cpu.erase(cpu.begin() + removeOffset, cpu.begin() + removeOffset + removeCount);
+    GLState::bindVertexArray(dynamicVao);
+    glDrawArrays(GL_TRIANGLES, (GLint)(offset / (GLintptr)sizeof(Vertex2D)), count);
 
-    // Remove record from shape list
-    shapes.erase(it);
+    stats.bytesUploaded += (uint64_t)count * sizeof(Vertex2D);
+    stats.drawCalls++;
+    stats.vertices += (uint64_t)count;
+}
 
-    // Update offsets of all shapes after the removed one
-    for (auto& r : shapes) {
-        if (r.offset > removeOffset)
-            r.offset -= removeCount;
+void Renderer2D::drawDynamic(const Shader& shader, const glm::mat4& viewProjection,
+                             const Mesh2D& mesh, const glm::mat4& model)
+{
+    if (mesh.vertices.empty() || mesh.indices.empty()) {
+        return;
     }
 
-    dirty = true;
+    const size_t vertexBytes = mesh.vertices.size() * sizeof(Vertex2D);
+    const size_t indexBytes = mesh.indices.size() * sizeof(uint32_t);
+
+    // Both halves go through the ring; the element buffer of dynamicVao is the ring too
+    GLintptr vertexOffset = stream.write(mesh.vertices.data(), vertexBytes, sizeof(Vertex2D));
+    if (vertexOffset < 0) {
+        return;
+    }
+
+    GLintptr indexOffset = stream.write(mesh.indices.data(), indexBytes);
+    if (indexOffset < 0) {
+        return;
+    }
+
+    shader.useShader();
+    shader.setViewProj(viewProjection);
+    shader.setUseBatch(false);
+    shader.setModel(model);
+    shader.setUseOverride(false);
+    shader.setSdf(glm::vec4(0.0f));
+
+    GLState::bindVertexArray(dynamicVao);
+    glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)mesh.indices.size(), GL_UNSIGNED_INT, (const void*)indexOffset,
+                             (GLint)(vertexOffset / (GLintptr)sizeof(Vertex2D)));
+
+    stats.bytesUploaded += (uint64_t)(vertexBytes + indexBytes);
+    stats.drawCalls++;
+    stats.vertices += (uint64_t)mesh.indices.size();
 }
 
 const ShapeRecord* Renderer2D::getRecord(ShapeHandle handle) const {
-    for (auto& r : shapes)
-        if (r.id == handle.id)
-            return &r;
-    return nullptr;
+    return shapes.get(handle);
+}
+
+void Renderer2D::queryPoint(glm::vec2 p, std::vector<ShapeHandle>& out) {
+    flushBounds();
+
+    spatial.queryPoint(p, [&](int proxy) {
+        const uint32_t slot = spatial.item(proxy);
+        const Aabb2D& b = shapes.at(slot).bounds;
+
+        if (p.x >= b.min.x && p.x <= b.max.x && p.y >= b.min.y && p.y <= b.max.y) {
+            out.push_back(shapes.handleAt(slot));
+        }
+    });
+}
+
+void Renderer2D::queryRect(const Aabb2D& box, std::vector<ShapeHandle>& out) {
+    flushBounds();
+
+    spatial.queryRect(box, [&](int proxy) {
+        const uint32_t slot = spatial.item(proxy);
+
+        if (shapes.at(slot).bounds.intersects(box)) {
+            out.push_back(shapes.handleAt(slot));
+        }
+    });
+}
+
+ShapeHandle Renderer2D::queryNearest(glm::vec2 p, float maxDistance) {
+    flushBounds();
+
+    const int proxy = spatial.nearest(p, maxDistance, [&](int leaf) {
+        return SpatialIndex::distance(shapes.at(spatial.item(leaf)).bounds, p);
+    });
+
+    if (proxy == SpatialIndex::null) {
+        return {};
+    }
+
+    return shapes.handleAt(spatial.item(proxy));
+}
+
+Mesh2D Renderer2D::getMesh(ShapeHandle handle) const {
+    Mesh2D mesh;
+    const ShapeRecord* r = shapes.get(handle);
+
+    if (!r) {
+        return mesh;
+    }
+
+    const int offset = vertexOffsetOf(*r);
+    const int indexOffset = indexOffsetOf(*r);
+
+    mesh.vertices.reserve(r->count);
+    for (int i = 0; i < r->count; ++i) {
+        mesh.vertices.push_back(GpuVertexLayout::unpack(cpu[offset + i], r->color));
+        if (r->flatColor) mesh.vertices.back().color = r->color;
+    }
+
+    mesh.indices.assign(cpuIndices.begin() + indexOffset,
+                        cpuIndices.begin() + indexOffset + r->indexCount);
+
+    return mesh;
 }
\ No newline at end of file
@@ -2,12 +2,58 @@
 #include <vector>
 #include <cstdint>
 #include <algorithm>
+#include <unordered_map>
 #include "Vertex2D.hpp"
+#include "Mesh2D.hpp"
+#include "MeshKey.hpp"
+#include "SdfPrimitive.hpp"
+#include "VertexFormat.hpp"
 #include "ShapeRecord.hpp"
+#include "SlotMap.hpp"
+#include "ShapeHandle.hpp"
+#include "StagingQueue.hpp"
+#include "VertexAllocator.hpp"
+#include "StreamBuffer.hpp"
+#include "SpatialIndex.hpp"
+#include "RadixSort.hpp"
 #include "Shader/Shader.hpp"
 
-struct ShapeHandle {
-    uint32_t id = UINT32_MAX;
+// Geometry stored once and referenced by any number of instances; freed when
+// the last reference goes away
+struct MeshRecord {
+    int offset = 0;
+    int count = 0;
+    int indexOffset = 0;
+    int indexCount = 0;
+    uint32_t refs = 0;
+    Aabb2D localBounds;
+};
+
+// PerShape: one set of uniforms + one draw call per shape.
+// Batched:  models/override colors live in a texture buffer, vertices carry
+//           their shape index and the whole scene goes out in one draw.
+enum class RenderPath {
+    PerShape,
+    Batched
+};
+
+struct RenderStats {
+    uint32_t drawCalls = 0;
+    uint64_t vertices = 0;         // vertices/indices submitted, times instances
+    uint32_t uniformUploads = 0;   // glUniform* calls actually issued
+    uint32_t stateChanges = 0;     // program/VAO/buffer/texture binds actually issued
+    uint32_t elidedCalls = 0;      // binds and uniforms skipped because the value was current
+    uint32_t shapesDrawn = 0;
+    uint32_t shapesCulled = 0;     // skipped because their bounds were outside the view
+    uint32_t staleHandles = 0;     // lookups with a removed or never-valid handle
+    uint32_t drawListSorts = 0;    // times drawAll re-sorted its draw order
+    uint32_t shapesStaged = 0;     // added from the staging queue
+
+    uint64_t bytesUploaded = 0;    // vertex, shape index and shape data bytes sent to the GPU
+    uint32_t bufferUploads = 0;    // glBufferData/glBufferSubData/glCopyBufferSubData calls
+
+    uint64_t bytesStreamed = 0;    // bytes that went through the streaming ring
+    uint32_t fenceWaits = 0;       // times the CPU had to block on a ring fence
 };
 
 class Renderer2D {
@@ -15,31 +61,246 @@ public:
     Renderer2D();
     ~Renderer2D();
 
+    // Triangle list; indices 0..count-1 are generated
     ShapeHandle addShape(const Vertex2D* verts, int count, const glm::mat4& model = glm::mat4(1.0f));
-    //ShapeHandle addShapeFront(const Vertex2D* verts, int count, const glm::mat4& model = glm::mat4(1.0f));
-    void setModel(ShapeHandle handle, const glm::mat4& matrix);
-    void setOverrideColor(ShapeHandle handle, const glm::vec3& color);
-    void clearOverrideColor(ShapeHandle h);
-    void updateVertices(ShapeHandle handle, const Vertex2D* verts, int count);
+    // Shared-vertex mesh; indices are relative to the shape's first vertex
+    ShapeHandle addShape(const Vertex2D* verts, int count, const uint32_t* indices, int indexCount,
+                         const glm::mat4& model = glm::mat4(1.0f));
+    ShapeHandle addShape(const Mesh2D& mesh, const glm::mat4& model = glm::mat4(1.0f));
+
+    // Shared geometry. addMesh() returns a mesh holding one reference for the
+    // caller (drop it with releaseMesh); cached meshes are built around the
+    // origin on first use and kept until clearMeshCache().
+    MeshHandle addMesh(const Mesh2D& mesh);
+    MeshHandle getCachedMesh(const MeshKey& key);
+    void releaseMesh(MeshHandle mesh);
+    void clearMeshCache();
+    size_t meshCount() const { return meshes.size(); }
+
+    // A shape that draws a shared mesh with its own model and flat color
+    ShapeHandle addInstance(MeshHandle mesh, const glm::mat4& model, const glm::vec3& color);
+    // Another shape drawing the same geometry; owned geometry is moved into a
+    // shared mesh on the first clone instead of being copied, so from then on
+    // the source is an instance of that mesh too
+    ShapeHandle cloneShape(ShapeHandle source, const glm::mat4& model);
+
+    // Circle/ellipse/rounded rect as a 4-vertex quad centered on the origin;
+    // the fragment shader evaluates the edge. Place it with model.
+    ShapeHandle addPrimitive(const SdfPrimitive& prim, const glm::mat4& model, const glm::vec3& color);
+
+    // Per-handle operations are O(1) and return false for a stale handle
+    bool setModel(ShapeHandle handle, const glm::mat4& matrix);
+    bool setOverrideColor(ShapeHandle handle, const glm::vec3& color);
+    bool clearOverrideColor(ShapeHandle h);
+    // Same vertex count only. A shape drawing a shared mesh (an instance, a
+    // clone or a cloned source) first gets its own copy of the geometry, so
+    // the other users of the mesh are left as they were.
+    bool updateVertices(ShapeHandle handle, const Vertex2D* verts, int count);
 
-    void setPosition(ShapeHandle handle, glm::vec2 position);
+    bool setPosition(ShapeHandle handle, glm::vec2 position);
 
-    void removeShape(ShapeHandle handle);
+    // Draw order is (layer, depth), lowest first; new shapes and clones go on
+    // top of their layer. Changing it is O(1): the draw order is re-sorted
+    // once at the next drawAll and no vertex data moves. Shapes that share
+    // layer and depth may be grouped by mesh to merge instanced draws.
+    bool setLayer(ShapeHandle handle, int layer);
+    bool setDepth(ShapeHandle handle, uint32_t depth);
+    bool bringToFront(ShapeHandle handle);
+    bool sendToBack(ShapeHandle handle);
 
+    bool removeShape(ShapeHandle handle);
+
+    bool isValid(ShapeHandle handle) const { return shapes.contains(handle); }
+
+    // bounds may lag setModel() until the next flushBounds()
     const ShapeRecord* getRecord(ShapeHandle handle) const;
-    const std::vector<Vertex2D>& getCPUBuffer() const { return cpu; };
+    // Packed copy of what is on the GPU; use getMesh() for Vertex2D data
+    const std::vector<GpuVertex>& getCPUBuffer() const { return cpu; };
+    const std::vector<uint32_t>& getIndexBuffer() const { return cpuIndices; }
+    Mesh2D getMesh(ShapeHandle handle) const;
+
+    size_t shapeCount() const { return shapes.size(); }
+
+    // Live slots in draw order (re-sorted here if needed) and the record in
+    // a slot, for renderers that walk the scene themselves
+    const std::vector<uint32_t>& getDrawOrder();
+    const ShapeRecord& getRecordAt(uint32_t slot) const { return shapes.at(slot); }
+
+    // First vertex and first index of a shape's geometry. Instances read
+    // them from their mesh, so compaction never has to visit them.
+    int vertexOffsetOf(const ShapeRecord& r) const {
+        return r.mesh == UINT32_MAX ? r.offset : meshes.at(r.mesh).offset;
+    }
+    int indexOffsetOf(const ShapeRecord& r) const {
+        return r.mesh == UINT32_MAX ? r.indexOffset : meshes.at(r.mesh).indexOffset;
+    }
+
+    // Worker threads build shapes through a StagingQueue::Writer on this
+    // queue. Everything published is committed by beginFrame(), or earlier
+    // with commitStaged(), which returns the number of shapes added.
+    StagingQueue& staging() { return stagingQueue; }
+    int commitStaged();
+
+    // Spatial queries over world bounds (not exact triangles), in no
+    // particular order; appended to out. Nearest measures from p to each
+    // shape's box, 0 when p is inside it.
+    void queryPoint(glm::vec2 p, std::vector<ShapeHandle>& out);
+    void queryRect(const Aabb2D& box, std::vector<ShapeHandle>& out);
+    ShapeHandle queryNearest(glm::vec2 p, float maxDistance = FLT_MAX);
+
+    // setModel() only stores the matrix; world bounds, the spatial index and
+    // the batched shape data catch up here for every shape moved since the
+    // last call. The queries, drawAll, drawShape and getDrawOrder flush
+    // first, so only direct readers of ShapeRecord::bounds need to call it.
+    void flushBounds();
+
+    void setRenderPath(RenderPath path) { renderPath = path; }
+    RenderPath getRenderPath() const { return renderPath; }
+
+    // Call once per frame: resets the counters returned by getStats(),
+    // commits staged work, fences last frame's streaming segment and runs one
+    // bounded compaction step
+    void beginFrame();
+    RenderStats getStats() const;
 
-    const std::vector<ShapeRecord>& getShapes() const { return shapes; }
+    // Slide live shapes down over freed vertex and index ranges, moving at
+    // most maxElements of each
+    int compact(int maxElements);
+    void setCompactionBudget(int elementsPerFrame) { compactionBudget = elementsPerFrame; }
+    VertexAllocatorStats getAllocatorStats() const { return allocator.stats(); }
+    VertexAllocatorStats getIndexAllocatorStats() const { return indexAllocator.stats(); }
 
+    // Both skip shapes whose world bounds miss the view of viewProjection.
+    // drawShape() can also take the selection's combined bounds to reject it
+    // as a whole before looking at individual shapes.
     void drawAll(const Shader& shader, const glm::mat4& viewProjection);
-    void drawShape(const Shader& shader, const glm::mat4& viewProjection, const std::vector<ShapeHandle>& selection);
+    void drawShape(const Shader& shader, const glm::mat4& viewProjection, const std::vector<ShapeHandle>& selection,
+                   const Aabb2D* selectionBounds = nullptr);
+
+    void setCulling(bool enabled) { culling = enabled; }
+    bool getCulling() const { return culling; }
+
+    // Geometry that only lives for this frame (cursors, previews, animation);
+    // streamed through the ring, never stored as a shape
+    void drawDynamic(const Shader& shader, const glm::mat4& viewProjection,
+                     const Vertex2D* verts, int count, const glm::mat4& model = glm::mat4(1.0f));
+    void drawDynamic(const Shader& shader, const glm::mat4& viewProjection,
+                     const Mesh2D& mesh, const glm::mat4& model = glm::mat4(1.0f));
 private:
-    GLuint vao{0}, vbo{0};
-    std::vector<Vertex2D> cpu;
-    std::vector<ShapeRecord> shapes;
-    bool dirty{false};
-    uint32_t nextID{1};
+    GLuint vao{0}, vbo{0}, ebo{0};
+    GLuint instanceVao{0};                 // same buffers, shape index per instance
+
+    // Staging ring for dirty spans and dynamic geometry
+    StreamBuffer stream;
+    GLuint dynamicVao{0};
+    std::vector<GpuVertex> cpu;
+    SlotMap<ShapeRecord, ShapeHandle> shapes;
+    StagingQueue stagingQueue{shapes};
+    SlotMap<MeshRecord, MeshHandle> meshes;
+    std::unordered_map<MeshKey, MeshHandle, MeshKeyHash> meshCache;
+    VertexAllocator allocator;
+    int compactionBudget{4096};
+
+    // Every live shape's bounds, by slot
+    SpatialIndex spatial;
+
+    // Depths handed to new shapes (upwards) and sendToBack (downwards)
+    uint32_t frontDepth{0x80000000u};
+    uint32_t backDepth{0x80000000u};
+
+    // Live slots sorted by sortKey(), rebuilt with drawList
+    std::vector<uint32_t> drawOrder;
+    std::vector<SortEntry> sortEntries, sortScratch;
+
+    std::vector<uint32_t> cpuIndices;
+    VertexAllocator indexAllocator;
+
+    // [begin, end) vertex / index spans changed since the last upload
+    std::vector<std::pair<int, int>> dirtyRanges;
+    std::vector<std::pair<int, int>> indexDirtyRanges;
+    int gpuCapacity{0};                    // vertices allocated in vbo/indexVbo
+    int gpuIndexCapacity{0};               // indices allocated in ebo
+
+    // Live shapes in draw order for the batched path. Shapes with their own
+    // geometry become glMultiDrawElementsBaseVertex arguments; consecutive
+    // instances of one mesh become a single instanced draw over their slots.
+    struct DrawList {
+        struct Run {
+            uint32_t mesh;      // mesh slot, or UINT32_MAX for a multi-draw run
+            int first;          // into counts/indices/baseVertices, or instanceSlots
+            int count;
+        };
+
+        std::vector<GLsizei> counts;
+        std::vector<const void*> indices;
+        std::vector<GLint> baseVertices;
+        std::vector<uint32_t> multiDrawSlots;   // shape slot behind each counts entry
+        std::vector<uint32_t> instanceSlots;
+        std::vector<Run> runs;
+        uint64_t multiDrawIndices{0};   // sum of counts
+
+        GLuint slotBuffer{0};           // instanceSlots on the GPU (attribute 2, divisor 1)
+        size_t slotCapacity{0};
+        bool slotsDirty{true};
+
+        void clear();
+        void add(uint32_t slot, const ShapeRecord& r);
+        size_t size() const { return counts.size() + instanceSlots.size(); }
+    };
+
+    DrawList drawList;
+    bool drawListDirty{true};
+    bool drawListOffsetsDirty{false};  // compaction moved geometry; order still holds
+
+    // drawAll's visible subset, kept while neither the view nor any bounds change
+    DrawList cullList;
+    Aabb2D cullView;
+    uint32_t cullListCulled{0};
+    bool cullDirty{true};
+    bool culling{true};
+
+    // Shapes whose model changed since the last flushBounds(); removed or
+    // reused slots fail the handle check and are skipped
+    std::vector<ShapeHandle> staleBounds;
+
+    RenderPath renderPath{RenderPath::PerShape};
+    RenderStats stats;
+
+    // Batched path resources
+    GLuint indexVbo{0};                    // per-vertex shape index (attribute 2)
+    GLuint shapeDataBuffer{0}, shapeDataTex{0};
+    std::vector<uint32_t> cpuShapeIndex;
+    std::vector<glm::vec4> shapeData;      // 6 texels per slot
+    size_t shapeDataCapacity{0};           // texels allocated in shapeDataBuffer
+    uint32_t shapeDirtyBegin{UINT32_MAX};  // [begin, end) slots changed since the last upload
+    uint32_t shapeDirtyEnd{0};
+    GLint maxShapeDataTexels{0};
+
+    DrawList batchList;
 
     void upload();
+    void uploadRanges(std::vector<std::pair<int, int>>& ranges, int limit,
+                      GLuint target, const void* data, size_t stride);
+    void uploadSpan(GLuint target, GLintptr offset, GLsizeiptr bytes, const void* data);
+    void markDirty(int offset, int count);
+    void markIndicesDirty(int offset, int count);
+    void resizeCpu(int vertices);
+    void writeShapeData(uint32_t slot);
+    void rebuildDrawList();
+    void patchOffsets(DrawList& list);
+    void sortSlots(std::vector<SortEntry>& entries);
+    static uint64_t sortKey(const ShapeRecord& r);
+    void rebuildCullList(const Aabb2D& view);
+    void updateBounds(uint32_t slot);
+    void uploadShapeData();
+    bool canBatch() const;
+    void bindBatch(const Shader& shader, const glm::mat4& viewProjection);
+    void drawBatch(DrawList& list);
+    ShapeHandle insertShape(ShapeHandle reserved, const Vertex2D* verts, int count, const uint32_t* indices,
+                            int indexCount, const glm::mat4& model);
+    void storeGeometry(uint32_t owner, const Vertex2D* verts, int count, const uint32_t* indices,
+                       int indexCount, int& offset, int& indexOffset);
+    void releaseMeshSlot(uint32_t slot);
+    void setShapeUniforms(const Shader& shader, const ShapeRecord& r);
     ShapeRecord* find(ShapeHandle handle);
-};
\ No newline at end of file
+};
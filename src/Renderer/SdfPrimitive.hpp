@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Shapes drawn as a single quad whose edge the fragment shader evaluates
+// from a signed distance, instead of being tessellated
+enum class SdfKind : uint8_t {
+    None = 0,
+    Ellipse = 1,        // circles are ellipses with equal radii
+    RoundedRect = 2
+};
+
+struct SdfPrimitive {
+    SdfKind kind = SdfKind::None;
+    glm::vec2 halfSize{0.0f};   // radii for ellipses
+    float cornerRadius = 0.0f;  // rounded rects only
+};
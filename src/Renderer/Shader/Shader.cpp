@@ -1,7 +1,44 @@
 #include "Shader.hpp"
+#include "../GLState.hpp"
 #include <stdexcept>
 #include <fstream>
 #include <sstream>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#if __has_include("EmbeddedShaders.hpp")
+#include "EmbeddedShaders.hpp"
+#define SCED_HAS_EMBEDDED_SHADERS 1
+#endif
+
+namespace {
+    std::string& cacheDir() {
+        static std::string dir = "shader_cache";
+        return dir;
+    }
+
+    Shader::LoadInfo& lastInfo() {
+        static Shader::LoadInfo info;
+        return info;
+    }
+
+    // FNV-1a; the key only has to tell sources and drivers apart
+    uint64_t hashInto(uint64_t h, const char* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            h ^= (unsigned char)data[i];
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    uint64_t hashInto(uint64_t h, const GLubyte* glString) {
+        const char* s = glString ? (const char*)glString : "";
+        return hashInto(h, s, std::strlen(s) + 1);
+    }
+}
 
 Shader::Shader(GLuint program) {
     programID = program;
@@ -12,46 +49,215 @@ Shader::Shader(GLuint program) {
 }
 
 Shader Shader::fromFiles(const std::string& vsPath, const std::string& fsPath) {
-    const std::string vsRC = readFile(vsPath);
-    const std::string fsRC = readFile(fsPath);
+    const auto start = std::chrono::steady_clock::now();
+
+    bool vsEmbedded = false, fsEmbedded = false;
+    const std::string vsRC = readSource(vsPath, vsEmbedded);
+    const std::string fsRC = readSource(fsPath, fsEmbedded);
+
+    Shader shader = fromSources(vsRC, fsRC);
 
-    GLuint vs = compile(GL_VERTEX_SHADER, vsRC.c_str());
-    GLuint fs = compile(GL_FRAGMENT_SHADER, fsRC.c_str());
+    // Report the whole setup, file reads included
+    lastInfo().milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    lastInfo().embeddedSource = vsEmbedded || fsEmbedded;
 
-    GLuint program = link(vs, fs);
+    return shader;
+}
+
+Shader Shader::fromSources(const std::string& vsSource, const std::string& fsSource) {
+    const auto start = std::chrono::steady_clock::now();
+
+    // Same sources on the same driver give the same key
+    uint64_t key = 0xcbf29ce484222325ull;
+    key = hashInto(key, vsSource.c_str(), vsSource.size() + 1);
+    key = hashInto(key, fsSource.c_str(), fsSource.size() + 1);
+    key = hashInto(key, glGetString(GL_VENDOR));
+    key = hashInto(key, glGetString(GL_RENDERER));
+    key = hashInto(key, glGetString(GL_VERSION));
+
+    GLuint program = loadBinary(key);
+    const bool cached = program != 0;
+
+    if (!cached) {
+        GLuint vs = compile(GL_VERTEX_SHADER, vsSource.c_str());
+        GLuint fs = compile(GL_FRAGMENT_SHADER, fsSource.c_str());
+
+        program = link(vs, fs);
 
-    glDeleteShader(vs);
-    glDeleteShader(fs);
+        glDeleteShader(vs);
+        glDeleteShader(fs);
+
+        saveBinary(program, key);
+    }
+
+    lastInfo() = {};
+    lastInfo().milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    lastInfo().fromBinaryCache = cached;
 
     return Shader(program);
 }
 
+void Shader::setBinaryCacheDir(const std::string& dir) {
+    cacheDir() = dir;
+}
+
+Shader::LoadInfo Shader::lastLoad() {
+    return lastInfo();
+}
+
+bool Shader::binaryCacheUsable() {
+    if (cacheDir().empty() || !glGetProgramBinary || !glProgramBinary || !glProgramParameteri) {
+        return false;
+    }
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+std::string Shader::binaryCachePath(uint64_t key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return (std::filesystem::path(cacheDir()) / name).string();
+}
+
+GLuint Shader::loadBinary(uint64_t key) {
+    if (!binaryCacheUsable()) {
+        return 0;
+    }
+
+    const std::string path = binaryCachePath(key);
+    std::ifstream ifs(path, std::ios::in | std::ios::binary | std::ios::ate);
+
+    if (!ifs) {
+        return 0;
+    }
+
+    // Binary format enum, then the driver's blob
+    const std::streamoff size = ifs.tellg();
+    uint32_t format = 0;
+
+    if (size <= (std::streamoff)sizeof(format)) {
+        return 0;
+    }
+
+    std::vector<char> blob((size_t)size - sizeof(format));
+    ifs.seekg(0);
+    ifs.read(reinterpret_cast<char*>(&format), sizeof(format));
+    ifs.read(blob.data(), (std::streamsize)blob.size());
+
+    if (!ifs) {
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, (GLenum)format, blob.data(), (GLsizei)blob.size());
+
+    GLint check = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &check);
+
+    // Driver update or corrupt file: drop it and compile
+    if (!check) {
+        glDeleteProgram(program);
+
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return 0;
+    }
+
+    return program;
+}
+
+void Shader::saveBinary(GLuint program, uint64_t key) {
+    if (!binaryCacheUsable()) {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<char> blob((size_t)length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, nullptr, &format, blob.data());
+
+    // Caching is best effort; failing to write only costs the next start
+    std::error_code ec;
+    std::filesystem::create_directories(cacheDir(), ec);
+
+    std::ofstream ofs(binaryCachePath(key), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!ofs) {
+        return;
+    }
+
+    const uint32_t format32 = format;
+    ofs.write(reinterpret_cast<const char*>(&format32), sizeof(format32));
+    ofs.write(blob.data(), (std::streamsize)blob.size());
+}
+
 void Shader::useShader() const {
-    glUseProgram(programID);
+    GLState::useProgram(programID);
+}
+
+template <typename T>
+bool Shader::unchanged(uint32_t bit, T& cached, const T& value) const {
+    const bool same = (cache.known & bit) && cached == value;
+
+    GLState::countUniform(same);
+
+    cached = value;
+    cache.known |= bit;
+    return same;
 }
 
 void Shader::setModel(const glm::mat4& matrix) const {
+    if (modelMatrix < 0 || unchanged(UniformCache::Model, cache.model, matrix)) return;
     glUniformMatrix4fv(modelMatrix, 1, GL_FALSE, &matrix[0][0]);
 }
 
 void Shader::setViewProj(const glm::mat4& matrix) const {
+    if (viewProjMatrix < 0 || unchanged(UniformCache::ViewProj, cache.viewProj, matrix)) return;
     glUniformMatrix4fv(viewProjMatrix, 1, GL_FALSE, &matrix[0][0]);
 }
 
 void Shader::setUseOverride(bool boolean) const {
+    if (useOverride < 0 || unchanged(UniformCache::UseOverride, cache.useOverride, boolean ? 1 : 0)) return;
     glUniform1i(useOverride, boolean ? 1 : 0);
 }
 
 void Shader::setOverride(const glm::vec3& color) const {
+    if (uOverride < 0 || unchanged(UniformCache::Override, cache.overrideColor, color)) return;
     glUniform3fv(uOverride, 1, &color[0]);
 }
 
+void Shader::setSdf(const glm::vec4& params) const {
+    if (uSdf < 0 || unchanged(UniformCache::Sdf, cache.sdf, params)) return;
+    glUniform4fv(uSdf, 1, &params[0]);
+}
+
+void Shader::setUseBatch(bool boolean) const {
+    if (useBatch < 0 || unchanged(UniformCache::UseBatch, cache.useBatch, boolean ? 1 : 0)) return;
+    glUniform1i(useBatch, boolean ? 1 : 0);
+}
+
+void Shader::setShapeDataUnit(int unit) const {
+    if (uShapeData < 0 || unchanged(UniformCache::ShapeData, cache.shapeDataUnit, unit)) return;
+    glUniform1i(uShapeData, unit);
+}
+
 Shader::Shader(Shader&& other) noexcept {
     programID = other.programID;
     modelMatrix = other.modelMatrix;
     viewProjMatrix = other.viewProjMatrix;
     useOverride = other.useOverride;
     uOverride = other.uOverride;
+    useBatch = other.useBatch;
+    uShapeData = other.uShapeData;
+    uSdf = other.uSdf;
+    cache = other.cache;
 
     other.programID = 0;
 }
@@ -70,6 +276,10 @@ Shader& Shader::operator=(Shader&& other) noexcept {
     viewProjMatrix = other.viewProjMatrix;
     useOverride = other.useOverride;
     uOverride = other.uOverride;
+    useBatch = other.useBatch;
+    uShapeData = other.uShapeData;
+    uSdf = other.uSdf;
+    cache = other.cache;
 
     other.programID = 0;
 
@@ -82,6 +292,30 @@ Shader::~Shader() {
     }
 }
 
+std::string Shader::readSource(const std::string& path, bool& embedded) {
+    embedded = false;
+
+    std::ifstream ifs(path, std::ios::in | std::ios::binary);
+    if (ifs) {
+        std::ostringstream oss;
+        oss << ifs.rdbuf();
+        return oss.str();
+    }
+
+#ifdef SCED_HAS_EMBEDDED_SHADERS
+    // Not next to the working directory: use the build's copy
+    const std::string name = std::filesystem::path(path).filename().string();
+    for (const auto& source : EmbeddedShaders::sources) {
+        if (name == source.name) {
+            embedded = true;
+            return source.text;
+        }
+    }
+#endif
+
+    return readFile(path);
+}
+
 std::string Shader::readFile(const std::string& path) {
     std::ifstream ifs(path, std::ios::in | std::ios::binary);
 
@@ -133,6 +367,10 @@ GLuint Shader::link(GLuint vs, GLuint fs) {
     glAttachShader(program, vs);
     glAttachShader(program, fs);
 
+    if (binaryCacheUsable()) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
     glLinkProgram(program);
 
     GLint check = GL_FALSE;
@@ -161,4 +399,7 @@ void Shader::cacheUniforms() {
     viewProjMatrix = glGetUniformLocation(programID, "viewProjMatrix");
     useOverride = glGetUniformLocation(programID, "useOverrideColor");
     uOverride = glGetUniformLocation(programID, "uOverrideColor");
+    useBatch = glGetUniformLocation(programID, "useBatch");
+    uShapeData = glGetUniformLocation(programID, "uShapeData");
+    uSdf = glGetUniformLocation(programID, "uSdf");
 }
\ No newline at end of file
@@ -1,16 +1,40 @@
 #pragma once
 #include <string>
 #include <glad/glad.h>
+#include <cstdint>
 #include <glm/glm.hpp>
 
 class Shader {
 private:
     GLuint programID{0};
     GLint modelMatrix{-1}, viewProjMatrix{-1}, useOverride{-1}, uOverride{-1};
+    GLint useBatch{-1}, uShapeData{-1}, uSdf{-1};
+
+    // Last value sent for each uniform. Uniforms keep their values in the
+    // program, so setting the same value again is skipped.
+    struct UniformCache {
+        enum : uint32_t { Model = 1, ViewProj = 2, UseOverride = 4, Override = 8,
+                          Sdf = 16, UseBatch = 32, ShapeData = 64 };
+        uint32_t known = 0;
+        glm::mat4 model{0.0f}, viewProj{0.0f};
+        glm::vec4 sdf{0.0f};
+        glm::vec3 overrideColor{0.0f};
+        int useOverride = 0, useBatch = 0, shapeDataUnit = 0;
+    };
+    mutable UniformCache cache;
+
+    template <typename T>
+    bool unchanged(uint32_t bit, T& cached, const T& value) const;
 
     static std::string readFile(const std::string& path);
+    static std::string readSource(const std::string& path, bool& embedded);
     static GLuint compile(GLenum type, const char* src);
     static GLuint link(GLuint vs, GLuint fs);
+
+    static bool binaryCacheUsable();
+    static std::string binaryCachePath(uint64_t key);
+    static GLuint loadBinary(uint64_t key);
+    static void saveBinary(GLuint program, uint64_t key);
     void cacheUniforms();
 
 public:
@@ -24,9 +48,25 @@ public:
 
     ~Shader();
 
+    // Paths that cannot be opened fall back to the file of the same name
+    // embedded at build time. A program binary cached for the same sources
+    // and driver is loaded instead of compiling.
     static Shader fromFiles(const std::string& vsPath, const std::string& fsPath);
+    static Shader fromSources(const std::string& vsSource, const std::string& fsSource);
 
-    //Bind
+    // Directory for cached program binaries ("shader_cache" by default);
+    // empty turns the cache off
+    static void setBinaryCacheDir(const std::string& dir);
+
+    // How the last fromFiles/fromSources call went, for startup reporting
+    struct LoadInfo {
+        double milliseconds = 0.0;
+        bool fromBinaryCache = false;
+        bool embeddedSource = false;
+    };
+    static LoadInfo lastLoad();
+
+    //Bind (skipped if the program is already current)
     void useShader() const;
 
     //Set Uniforms
@@ -34,6 +74,12 @@ public:
     void setViewProj(const glm::mat4& matrix) const;
     void setUseOverride(bool boolean) const;
     void setOverride(const glm::vec3& color) const;
+    // Analytic primitive: (half size x, half size y, corner radius, kind), kind 0 = none
+    void setSdf(const glm::vec4& params) const;
+
+    // Batched path: per-shape data is read from a texture buffer on this unit
+    void setUseBatch(bool boolean) const;
+    void setShapeDataUnit(int unit) const;
 
     GLuint id() const {
         return programID;
@@ -1,13 +1,45 @@
 #version 330 core
 layout(location=0) in vec2 aPos;
 layout(location=1) in vec3 aColor;
+layout(location=2) in uint aShapeIndex;
 
 uniform mat4 modelMatrix;
 uniform mat4 viewProjMatrix;
 
+uniform bool useOverrideColor;
+uniform vec3 uOverrideColor;
+
+// Analytic primitive: half size, corner radius, kind (0 none, 1 ellipse, 2 rounded rect)
+uniform vec4 uSdf;
+
+// Batched path: 6 texels per shape (4 model columns, override rgb + flag, sdf params)
+uniform bool useBatch;
+uniform samplerBuffer uShapeData;
+
 out vec3 vColor;
+out vec2 vLocal;
+flat out vec4 vSdf;
 
 void main() {
-    gl_Position = viewProjMatrix * modelMatrix * vec4(aPos, 0.0, 1.0);
-    vColor = aColor;
-}
\ No newline at end of file
+    mat4 model = modelMatrix;
+    bool useOverride = useOverrideColor;
+    vec3 overrideColor = uOverrideColor;
+    vec4 sdf = uSdf;
+
+    if (useBatch) {
+        int base = int(aShapeIndex) * 6;
+        model = mat4(texelFetch(uShapeData, base + 0),
+                     texelFetch(uShapeData, base + 1),
+                     texelFetch(uShapeData, base + 2),
+                     texelFetch(uShapeData, base + 3));
+        vec4 o = texelFetch(uShapeData, base + 4);
+        useOverride = o.w > 0.5;
+        overrideColor = o.rgb;
+        sdf = texelFetch(uShapeData, base + 5);
+    }
+
+    gl_Position = viewProjMatrix * model * vec4(aPos, 0.0, 1.0);
+    vColor = useOverride ? overrideColor : aColor;
+    vLocal = aPos;
+    vSdf = sdf;
+}
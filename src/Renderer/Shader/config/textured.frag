@@ -0,0 +1,13 @@
+#version 330 core
+in vec2 vUV;
+out vec4 FragColor;
+
+// Premultiplied-alpha texture; the override color replaces rgb but keeps coverage
+uniform sampler2D uTexture;
+uniform bool useOverrideColor;
+uniform vec3 uOverrideColor;
+
+void main() {
+    vec4 texel = texture(uTexture, vUV);
+    FragColor = useOverrideColor ? vec4(uOverrideColor * texel.a, texel.a) : texel;
+}
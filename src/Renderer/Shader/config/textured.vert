@@ -0,0 +1,12 @@
+#version 330 core
+layout(location=0) in vec2 aPos;
+layout(location=1) in vec2 aUV;
+
+uniform mat4 viewProjMatrix;
+
+out vec2 vUV;
+
+void main() {
+    gl_Position = viewProjMatrix * vec4(aPos, 0.0, 1.0);
+    vUV = aUV;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+// Slot index + generation. Removing a shape bumps its slot's generation, so
+// old handles to it are detected as stale instead of aliasing a new shape.
+struct ShapeHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool valid() const { return index != UINT32_MAX; }
+
+    // Packed form, for use as a map key
+    uint64_t key() const { return (uint64_t(generation) << 32) | index; }
+
+    bool operator==(const ShapeHandle& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const ShapeHandle& o) const { return !(*this == o); }
+};
+
+// Same scheme for meshes shared between instances
+struct MeshHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool valid() const { return index != UINT32_MAX; }
+};
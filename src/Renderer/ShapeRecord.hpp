@@ -1,11 +1,24 @@
 #pragma once
+#include <cstdint>
 #include <glm/glm.hpp>
+#include "Aabb2D.hpp"
 
 struct ShapeRecord {
-    uint32_t id;
-    int offset;
-    int count;
+    int offset;             // first vertex (also the base vertex for its indices); unused with a mesh
+    int count;              // vertex count
+    int indexOffset;        // first index in the element buffer; unused with a mesh
+    int indexCount;
     glm::mat4 model{1.0f};
+    Aabb2D localBounds;         // vertex extent before model
+    Aabb2D bounds;              // localBounds through model, used for culling
+    bool boundsStale=false;     // model changed since bounds were last computed
+    int proxy=-1;               // leaf in Renderer2D's spatial index
+    int16_t layer=0;            // draw order: layer, then depth, lower first
+    uint32_t depth=0;
+    glm::vec3 color{1, 1, 1};   // first vertex color, or the instance color
+    bool flatColor=false;       // draw with color instead of the vertex colors
+    uint32_t mesh=UINT32_MAX;   // shared mesh slot, UINT32_MAX if the shape owns its vertices
+    glm::vec4 sdf{0.0f};        // analytic primitive: half size, corner radius, SdfKind (0 = none)
     bool useOverride=false;
     glm::vec3 overrideColor{1, 1, 1};
 };
\ No newline at end of file
@@ -2,10 +2,11 @@
 #include <vector>
 #include <glm/glm.hpp>
 #include "Vertex2D.hpp"
+#include "Mesh2D.hpp"
 #include <cmath>
 
 namespace Shapes {
-    std::vector<Vertex2D> makeRectangle (glm::vec2 minXY, glm::vec2 maxXY, const glm::vec3& color) {
+    inline std::vector<Vertex2D> makeRectangle (glm::vec2 minXY, glm::vec2 maxXY, const glm::vec3& color) {
         const glm::vec2 bottomLeft = minXY;
         const glm::vec2 bottomRight = {maxXY.x, minXY.y};
         const glm::vec2 topRight = maxXY;
@@ -17,7 +18,7 @@ namespace Shapes {
         };
     }
 
-    std::vector<Vertex2D> makeTriangle(glm::vec2 vec1, glm::vec2 vec2, glm::vec2 vec3, const glm::vec3& color) {
+    inline std::vector<Vertex2D> makeTriangle(glm::vec2 vec1, glm::vec2 vec2, glm::vec2 vec3, const glm::vec3& color) {
         return { {vec1, color}, {vec2, color}, {vec3, color} };
     }
     inline std::vector<Vertex2D> makeCircle(glm::vec2 center, float radius, int segments, const glm::vec3& color) {
@@ -78,4 +79,67 @@ namespace Shapes {
         if (sides < 3) return {};
         return makeCircle(center, radius, sides, color);
     }
+    // ---------------------------------------------------------------
+    // Indexed versions: each vertex is stored once and shared by index
+    // ---------------------------------------------------------------
+    inline Mesh2D makeRectangleMesh(glm::vec2 minXY, glm::vec2 maxXY, const glm::vec3& color) {
+        Mesh2D mesh;
+        mesh.vertices = {
+            {minXY, color}, {{maxXY.x, minXY.y}, color}, {maxXY, color}, {{minXY.x, maxXY.y}, color}
+        };
+        mesh.indices = { 0, 1, 2, 0, 2, 3 };
+        return mesh;
+    }
+
+    inline Mesh2D makeTriangleMesh(glm::vec2 vec1, glm::vec2 vec2, glm::vec2 vec3, const glm::vec3& color) {
+        Mesh2D mesh;
+        mesh.vertices = { {vec1, color}, {vec2, color}, {vec3, color} };
+        mesh.indices = { 0, 1, 2 };
+        return mesh;
+    }
+
+    // Triangle fan as a center vertex plus one vertex per rim point
+    inline Mesh2D makeEllipseMesh(glm::vec2 center, glm::vec2 radii, int segments, const glm::vec3& color) {
+        Mesh2D mesh;
+        if (radii.x <= 0.0f || radii.y <= 0.0f || segments < 3) return mesh;
+
+        const float twoPi = 6.2831853071795864769f;
+
+        mesh.vertices.reserve(static_cast<size_t>(segments) + 1);
+        mesh.indices.reserve(static_cast<size_t>(segments) * 3);
+
+        mesh.vertices.push_back({ center, color });
+        for (int i = 0; i < segments; ++i) {
+            float a = (twoPi * i) / static_cast<float>(segments);
+            mesh.vertices.push_back({ center + glm::vec2(radii.x * std::cos(a), radii.y * std::sin(a)), color });
+        }
+
+        for (int i = 1; i <= segments; ++i) {
+            uint32_t next = (i == segments) ? 1u : static_cast<uint32_t>(i + 1);
+            mesh.indices.push_back(0);
+            mesh.indices.push_back(static_cast<uint32_t>(i));
+            mesh.indices.push_back(next);
+        }
+
+        return mesh;
+    }
+
+    inline Mesh2D makeCircleMesh(glm::vec2 center, float radius, int segments, const glm::vec3& color) {
+        if (radius <= 0.0f) return {};
+        return makeEllipseMesh(center, glm::vec2(radius), segments, color);
+    }
+
+    inline Mesh2D makeRegularPolygonMesh(glm::vec2 center, float radius, int sides, const glm::vec3& color) {
+        if (sides < 3) return {};
+        return makeCircleMesh(center, radius, sides, color);
+    }
+
+    // Wrap an existing triangle list; indices are just 0..n-1
+    inline Mesh2D meshFromTriangles(std::vector<Vertex2D> vertices) {
+        Mesh2D mesh;
+        mesh.indices.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) mesh.indices[i] = static_cast<uint32_t>(i);
+        mesh.vertices = std::move(vertices);
+        return mesh;
+    }
 }
\ No newline at end of file
@@ -11,9 +11,28 @@ public:
         return Shapes::makeCircle(c, r, segs, col);
     }
 
+    Mesh2D generateMesh() const override {
+        return Shapes::makeCircleMesh(c, r, segs, col);
+    }
+
     int getCenterX() const { return c.x; }
     int getCenterY() const { return c.y; }
 
+    bool instanceKey(MeshKey& key, glm::vec2& origin, glm::vec3& color) const override {
+        key = { MeshKind::Circle, segs, glm::vec2(r) };
+        origin = c;
+        color = col;
+        return true;
+    }
+
+    bool sdfPrimitive(SdfPrimitive& prim, glm::vec2& origin, glm::vec3& color) const override {
+        if (!analytic) return false;
+        prim = { SdfKind::Ellipse, glm::vec2(r), 0.0f };
+        origin = c;
+        color = col;
+        return true;
+    }
+
 private:
     glm::vec2 c;
     float     r;
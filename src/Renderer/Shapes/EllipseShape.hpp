@@ -11,6 +11,25 @@ public:
         return Shapes::makeEllipse(c, radii, segs, col);
     }
 
+    Mesh2D generateMesh() const override {
+        return Shapes::makeEllipseMesh(c, radii, segs, col);
+    }
+
+    bool instanceKey(MeshKey& key, glm::vec2& origin, glm::vec3& color) const override {
+        key = { MeshKind::Ellipse, segs, radii };
+        origin = c;
+        color = col;
+        return true;
+    }
+
+    bool sdfPrimitive(SdfPrimitive& prim, glm::vec2& origin, glm::vec3& color) const override {
+        if (!analytic) return false;
+        prim = { SdfKind::Ellipse, radii, 0.0f };
+        origin = c;
+        color = col;
+        return true;
+    }
+
 private:
     glm::vec2 c;
     glm::vec2 radii;    // {rx, ry}
@@ -4,6 +4,9 @@
 #include <vector>
 #include <glm/glm.hpp>
 #include "../Vertex2D.hpp"
+#include "../Mesh2D.hpp"
+#include "../MeshKey.hpp"
+#include "../SdfPrimitive.hpp"
 
 // This is the abstract base class (interface)
 struct IShape2D {
@@ -11,6 +14,36 @@ struct IShape2D {
 
     // Generate triangle-list vertices in model/local space.
     virtual std::vector<Vertex2D> generateVertices() const = 0;
+
+    // Generate a shared-vertex indexed mesh in model/local space.
+    // Default wraps the triangle list; shapes override to share vertices.
+    virtual Mesh2D generateMesh() const {
+        Mesh2D mesh;
+        mesh.vertices = generateVertices();
+        mesh.indices.resize(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.indices.size(); ++i) mesh.indices[i] = static_cast<uint32_t>(i);
+        return mesh;
+    }
+
+    // Parametric shapes fill in the key of their geometry around the origin,
+    // where to place it and its color, so Renderer2D can instance one cached
+    // mesh instead of storing the vertices again. Others return false.
+    virtual bool instanceKey(MeshKey& /*key*/, glm::vec2& /*origin*/, glm::vec3& /*color*/) const {
+        return false;
+    }
+
+    // Opt into analytic rendering. Shapes that support it (circles, ellipses,
+    // rectangles) are then drawn as one quad with a per-pixel antialiased edge.
+    IShape2D& setAnalytic(bool enable) { analytic = enable; return *this; }
+    bool isAnalytic() const { return analytic; }
+
+    // Filled in when the shape is analytic; origin is the primitive's center
+    virtual bool sdfPrimitive(SdfPrimitive& /*prim*/, glm::vec2& /*origin*/, glm::vec3& /*color*/) const {
+        return false;
+    }
+
+protected:
+    bool analytic = false;
 };
 
 #endif // SCED_ISHAPE2D_HPP
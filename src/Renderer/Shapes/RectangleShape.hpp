@@ -11,7 +11,30 @@ public:
         return Shapes::makeRectangle(min, max, col);
     }
 
+    Mesh2D generateMesh() const override {
+        return Shapes::makeRectangleMesh(min, max, col);
+    }
+
+    bool instanceKey(MeshKey& key, glm::vec2& origin, glm::vec3& color) const override {
+        key = { MeshKind::Rectangle, 0, max - min };
+        origin = min;
+        color = col;
+        return true;
+    }
+
+    // Only visible on the analytic path; tessellated rectangles stay square
+    void setCornerRadius(float radius) { corner = radius; }
+
+    bool sdfPrimitive(SdfPrimitive& prim, glm::vec2& origin, glm::vec3& color) const override {
+        if (!analytic) return false;
+        prim = { SdfKind::RoundedRect, (max - min) * 0.5f, corner };
+        origin = (min + max) * 0.5f;
+        color = col;
+        return true;
+    }
+
 private:
     glm::vec2 min, max;
     glm::vec3 col;
+    float corner = 0.0f;
 };
@@ -11,6 +11,17 @@ public:
         return Shapes::makeRegularPolygon(c, r, n, col);
     }
 
+    Mesh2D generateMesh() const override {
+        return Shapes::makeRegularPolygonMesh(c, r, n, col);
+    }
+
+    bool instanceKey(MeshKey& key, glm::vec2& origin, glm::vec3& color) const override {
+        key = { MeshKind::RegularPolygon, n, glm::vec2(r) };
+        origin = c;
+        color = col;
+        return true;
+    }
+
 private:
     glm::vec2 c;
     float     r;
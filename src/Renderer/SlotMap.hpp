@@ -0,0 +1,137 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <atomic>
+
+// Generational slot map. Handle is any struct with uint32_t index/generation
+// members; a handle whose generation no longer matches its slot is stale.
+// Live slots are also kept on an intrusive list so iteration follows
+// insertion order, with O(1) insert and remove.
+//
+// reserve() is the one member that may be called from any thread: it hands
+// out a never-used slot index (generation 1) without touching the slots, and
+// the owning thread fills it later with insertAt().
+template <typename T, typename Handle>
+class SlotMap {
+public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    Handle insert(const T& value) {
+        uint32_t index;
+
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            index = fresh.fetch_add(1, std::memory_order_relaxed);
+            grow(index);
+        }
+
+        link(index, value);
+        return Handle{index, slots[index].generation};
+    }
+
+    // Thread-safe; the handle is not valid until insertAt() fills it.
+    // A reservation that is never filled leaves its slot unused.
+    Handle reserve() {
+        return Handle{fresh.fetch_add(1, std::memory_order_relaxed), 1};
+    }
+
+    bool insertAt(Handle h, const T& value) {
+        if (h.index >= fresh.load(std::memory_order_relaxed)) return false;
+        grow(h.index);
+
+        if (slots[h.index].alive || slots[h.index].generation != h.generation) return false;
+
+        link(h.index, value);
+        return true;
+    }
+
+    bool remove(Handle h) {
+        if (!contains(h)) return false;
+
+        Slot& s = slots[h.index];
+
+        if (s.prev != npos) slots[s.prev].next = s.next;
+        else head = s.next;
+        if (s.next != npos) slots[s.next].prev = s.prev;
+        else tail = s.prev;
+
+        s.alive = false;
+        s.value = T{};
+        ++s.generation;     // invalidates every outstanding handle
+        freeSlots.push_back(h.index);
+
+        --count;
+        return true;
+    }
+
+    bool contains(Handle h) const {
+        return h.index < slots.size() &&
+               slots[h.index].alive &&
+               slots[h.index].generation == h.generation;
+    }
+
+    T* get(Handle h) { return contains(h) ? &slots[h.index].value : nullptr; }
+    const T* get(Handle h) const { return contains(h) ? &slots[h.index].value : nullptr; }
+
+    // Unchecked access by slot index; the slot must be live
+    T& at(uint32_t index) { return slots[index].value; }
+    const T& at(uint32_t index) const { return slots[index].value; }
+
+    // Current handle for a live slot index
+    Handle handleAt(uint32_t index) const { return Handle{index, slots[index].generation}; }
+
+    // Visit live values in insertion order: fn(uint32_t index, T& value)
+    template <typename Fn>
+    void forEach(Fn&& fn) {
+        for (uint32_t i = head; i != npos; i = slots[i].next) fn(i, slots[i].value);
+    }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (uint32_t i = head; i != npos; i = slots[i].next) fn(i, slots[i].value);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Number of slots ever allocated (live + free); slot indices are below this
+    size_t capacity() const { return slots.size(); }
+
+private:
+    void grow(uint32_t index) {
+        // Reserved slots in between stay dead until they are filled
+        if (index >= slots.size()) slots.resize(index + 1);
+    }
+
+    void link(uint32_t index, const T& value) {
+        Slot& s = slots[index];
+        s.value = value;
+        s.alive = true;
+
+        // Link at the tail
+        s.prev = tail;
+        s.next = npos;
+        if (tail != npos) slots[tail].next = index;
+        else head = index;
+        tail = index;
+
+        ++count;
+    }
+
+    struct Slot {
+        T value{};
+        uint32_t generation = 1;
+        uint32_t prev = npos;
+        uint32_t next = npos;
+        bool alive = false;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::atomic<uint32_t> fresh{0};     // next slot index never handed out
+    uint32_t head = npos;
+    uint32_t tail = npos;
+    size_t count = 0;
+};
@@ -0,0 +1,467 @@
+#include "SoftwareRasterizer.hpp"
+#include "Renderer2D.hpp"
+#include "../core/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace {
+    constexpr int kTile = 64;
+
+    // The few vector operations the edge loop needs. F holds floats, M a
+    // per-lane mask, I packed RGBA8 pixels.
+#if defined(__AVX2__)
+    struct Simd {
+        static constexpr int width = 8;
+        using F = __m256;
+        using M = __m256;
+        using I = __m256i;
+
+        static F set(float v) { return _mm256_set1_ps(v); }
+        static F ramp() { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+        static F add(F a, F b) { return _mm256_add_ps(a, b); }
+        static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+        static F clamp01(F a) { return _mm256_min_ps(_mm256_max_ps(a, _mm256_setzero_ps()), _mm256_set1_ps(1.0f)); }
+        static M inside(F w, bool tie) {
+            return tie ? _mm256_cmp_ps(w, _mm256_setzero_ps(), _CMP_GE_OQ)
+                       : _mm256_cmp_ps(w, _mm256_setzero_ps(), _CMP_GT_OQ);
+        }
+        static M both(M a, M b) { return _mm256_and_ps(a, b); }
+        static int bits(M m) { return _mm256_movemask_ps(m); }
+        static void store(float* out, F a) { _mm256_storeu_ps(out, a); }
+
+        static I pack(F r, F g, F b) {
+            const F scale = _mm256_set1_ps(255.0f);
+            I out = _mm256_cvtps_epi32(_mm256_mul_ps(clamp01(r), scale));
+            out = _mm256_or_si256(out, _mm256_slli_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(clamp01(g), scale)), 8));
+            out = _mm256_or_si256(out, _mm256_slli_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(clamp01(b), scale)), 16));
+            return _mm256_or_si256(out, _mm256_set1_epi32((int)0xFF000000u));
+        }
+        static void write(uint32_t* dst, M m, I pixels) {
+            const I old = _mm256_loadu_si256((const __m256i*)dst);
+            _mm256_storeu_si256((__m256i*)dst, _mm256_blendv_epi8(old, pixels, _mm256_castps_si256(m)));
+        }
+    };
+#elif defined(__SSE2__) || defined(_M_X64)
+    struct Simd {
+        static constexpr int width = 4;
+        using F = __m128;
+        using M = __m128;
+        using I = __m128i;
+
+        static F set(float v) { return _mm_set1_ps(v); }
+        static F ramp() { return _mm_setr_ps(0, 1, 2, 3); }
+        static F add(F a, F b) { return _mm_add_ps(a, b); }
+        static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+        static F clamp01(F a) { return _mm_min_ps(_mm_max_ps(a, _mm_setzero_ps()), _mm_set1_ps(1.0f)); }
+        static M inside(F w, bool tie) {
+            return tie ? _mm_cmpge_ps(w, _mm_setzero_ps()) : _mm_cmpgt_ps(w, _mm_setzero_ps());
+        }
+        static M both(M a, M b) { return _mm_and_ps(a, b); }
+        static int bits(M m) { return _mm_movemask_ps(m); }
+        static void store(float* out, F a) { _mm_storeu_ps(out, a); }
+
+        static I pack(F r, F g, F b) {
+            const F scale = _mm_set1_ps(255.0f);
+            I out = _mm_cvtps_epi32(_mm_mul_ps(clamp01(r), scale));
+            out = _mm_or_si128(out, _mm_slli_epi32(_mm_cvtps_epi32(_mm_mul_ps(clamp01(g), scale)), 8));
+            out = _mm_or_si128(out, _mm_slli_epi32(_mm_cvtps_epi32(_mm_mul_ps(clamp01(b), scale)), 16));
+            return _mm_or_si128(out, _mm_set1_epi32((int)0xFF000000u));
+        }
+        static void write(uint32_t* dst, M m, I pixels) {
+            const I mask = _mm_castps_si128(m);
+            const I old = _mm_loadu_si128((const __m128i*)dst);
+            _mm_storeu_si128((__m128i*)dst, _mm_or_si128(_mm_and_si128(mask, pixels), _mm_andnot_si128(mask, old)));
+        }
+    };
+#else
+    struct Simd {
+        static constexpr int width = 1;
+        using F = float;
+        using M = bool;
+        using I = uint32_t;
+
+        static F set(float v) { return v; }
+        static F ramp() { return 0.0f; }
+        static F add(F a, F b) { return a + b; }
+        static F mul(F a, F b) { return a * b; }
+        static F clamp01(F a) { return std::min(std::max(a, 0.0f), 1.0f); }
+        static M inside(F w, bool tie) { return tie ? w >= 0.0f : w > 0.0f; }
+        static M both(M a, M b) { return a && b; }
+        static int bits(M m) { return m ? 1 : 0; }
+        static void store(float* out, F a) { *out = a; }
+
+        static I pack(F r, F g, F b) {
+            return (uint32_t)std::nearbyint(clamp01(r) * 255.0f) |
+                   (uint32_t)std::nearbyint(clamp01(g) * 255.0f) << 8 |
+                   (uint32_t)std::nearbyint(clamp01(b) * 255.0f) << 16 | 0xFF000000u;
+        }
+        static void write(uint32_t* dst, M m, I pixels) {
+            if (m) *dst = pixels;
+        }
+    };
+#endif
+
+    uint32_t packPixel(const glm::vec4& c) {
+        const glm::vec4 v = glm::round(glm::clamp(c, 0.0f, 1.0f) * 255.0f);
+        return (uint32_t)v.r | (uint32_t)v.g << 8 | (uint32_t)v.b << 16 | (uint32_t)v.a << 24;
+    }
+
+    glm::vec4 unpackPixel(uint32_t p) {
+        return glm::vec4(p & 0xFF, (p >> 8) & 0xFF, (p >> 16) & 0xFF, p >> 24) / 255.0f;
+    }
+
+    // Same distance functions as flat.frag
+    float sdEllipse(glm::vec2 p, glm::vec2 r) {
+        const float k0 = glm::length(p / r);
+        const float k1 = glm::length(p / (r * r));
+        if (k1 < 1e-6f) return -std::min(r.x, r.y);
+        return k0 * (k0 - 1.0f) / k1;
+    }
+
+    float sdRoundedBox(glm::vec2 p, glm::vec2 halfSize, float radius) {
+        const glm::vec2 q = glm::abs(p) - halfSize + radius;
+        return glm::length(glm::max(q, 0.0f)) + std::min(std::max(q.x, q.y), 0.0f) - radius;
+    }
+
+    float sdf(const glm::vec4& params, glm::vec2 p) {
+        return params.w < 1.5f ? sdEllipse(p, glm::vec2(params)) : sdRoundedBox(p, glm::vec2(params), params.z);
+    }
+
+    // Vertices snap to 1/256 pixel so shared edges evaluate alike in both triangles
+    float snap(float v) {
+        return std::round(v * 256.0f) / 256.0f;
+    }
+}
+
+SoftwareRasterizer::SoftwareRasterizer(int width, int height, int threads) : width(0), height(0), stride(0),
+                                                                              paddedHeight(0), threadCount(1) {
+    setThreads(threads);
+    resize(width, height);
+}
+
+void SoftwareRasterizer::resize(int newWidth, int newHeight) {
+    width = std::max(newWidth, 1);
+    height = std::max(newHeight, 1);
+
+    tilesX = (width + kTile - 1) / kTile;
+    tilesY = (height + kTile - 1) / kTile;
+    stride = tilesX * kTile;
+    paddedHeight = tilesY * kTile;
+
+    color.assign((size_t)stride * paddedHeight, 0xFF000000u);
+    bins.resize((size_t)tilesX * tilesY);
+}
+
+int SoftwareRasterizer::simdWidth() {
+    return Simd::width;
+}
+
+void SoftwareRasterizer::setThreads(int threads) {
+    threadCount = threads > 0 ? threads : (int)std::max(1u, std::thread::hardware_concurrency());
+}
+
+void SoftwareRasterizer::clear(const glm::vec4& c) {
+    std::fill(color.begin(), color.end(), packPixel(c));
+}
+
+void SoftwareRasterizer::draw(Renderer2D& renderer, const glm::mat4& viewProjection) {
+    SCED_PROFILE_SCOPE("SoftwareRasterizer::draw");
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+
+    stats = {};
+    triangles.clear();
+    for (auto& bin : bins) bin.clear();
+
+    const Aabb2D view = Aabb2D::view(viewProjection);
+
+    for (uint32_t slot : renderer.getDrawOrder()) {
+        if (renderer.getCulling() && !renderer.getRecordAt(slot).bounds.intersects(view)) {
+            stats.shapesCulled++;
+            continue;
+        }
+
+        setupShape(renderer, slot, viewProjection);
+        stats.shapesDrawn++;
+    }
+
+    stats.triangles = (uint32_t)triangles.size();
+
+    std::vector<int> work;
+    for (int tile = 0; tile < (int)bins.size(); ++tile) {
+        if (!bins[tile].empty()) work.push_back(tile);
+    }
+
+    const auto binned = Clock::now();
+
+    // Tiles share nothing, so workers just take the next one
+    std::atomic<int> next{0};
+    auto worker = [&] {
+        for (int i = next.fetch_add(1); i < (int)work.size(); i = next.fetch_add(1)) {
+            rasterizeTile(work[i]);
+        }
+    };
+
+    const int workers = std::max(1, std::min(threadCount, (int)work.size()));
+    std::vector<std::thread> pool;
+    for (int i = 1; i < workers; ++i) pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool) t.join();
+
+    stats.threads = (uint32_t)workers;
+    stats.setupMilliseconds = std::chrono::duration<double, std::milli>(binned - start).count();
+    stats.rasterMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - binned).count();
+}
+
+void SoftwareRasterizer::setupShape(Renderer2D& renderer, uint32_t slot, const glm::mat4& viewProjection) {
+    const ShapeRecord& r = renderer.getRecordAt(slot);
+    const std::vector<GpuVertex>& vertices = renderer.getCPUBuffer();
+    const std::vector<uint32_t>& indices = renderer.getIndexBuffer();
+    const int offset = renderer.vertexOffsetOf(r);
+    const int indexOffset = renderer.indexOffsetOf(r);
+
+    const glm::mat4 mvp = viewProjection * r.model;
+
+    // Color selection as in flat.vert with Renderer2D's uniforms
+    const bool useOverride = r.flatColor || r.useOverride;
+    const glm::vec3 overrideColor = r.useOverride ? r.overrideColor : r.color;
+
+    for (int i = 0; i + 2 < r.indexCount; i += 3) {
+        glm::vec2 screen[3], local[3];
+        glm::vec3 colors[3];
+        bool visible = true;
+
+        for (int k = 0; k < 3; ++k) {
+            const Vertex2D v = GpuVertexLayout::unpack(vertices[offset + indices[indexOffset + i + k]], r.color);
+            const glm::vec4 clip = mvp * glm::vec4(v.pos, 0.0f, 1.0f);
+
+            // No clipping: 2D views are orthographic, so w stays 1
+            if (clip.w <= 0.0f) {
+                visible = false;
+                break;
+            }
+
+            screen[k] = { snap((clip.x / clip.w * 0.5f + 0.5f) * width),
+                          snap((0.5f - clip.y / clip.w * 0.5f) * height) };
+            colors[k] = useOverride ? overrideColor : v.color;
+            local[k] = v.pos;
+        }
+
+        if (visible) {
+            addTriangle(screen, colors, local, r.sdf);
+        }
+    }
+}
+
+void SoftwareRasterizer::addTriangle(const glm::vec2 screen[3], const glm::vec3 colors[3], const glm::vec2 local[3],
+                                     const glm::vec4& sdf) {
+    int order[3] = { 0, 1, 2 };
+
+    float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) -
+                 (screen[1].y - screen[0].y) * (screen[2].x - screen[0].x);
+
+    if (!(std::fabs(area) > 0.0f) || !std::isfinite(area)) {
+        return;
+    }
+
+    // GL draws both windings; flip to one so inside is always >= 0
+    if (area < 0.0f) {
+        std::swap(order[1], order[2]);
+        area = -area;
+    }
+
+    Triangle t;
+    glm::vec2 lo = screen[0], hi = screen[0];
+
+    for (int i = 0; i < 3; ++i) {
+        // Edge opposite vertex i, so its value / area is vertex i's weight
+        const glm::vec2 a = screen[order[(i + 1) % 3]];
+        const glm::vec2 b = screen[order[(i + 2) % 3]];
+
+        t.a[i] = a.y - b.y;
+        t.b[i] = b.x - a.x;
+        t.c[i] = (b.y - a.y) * a.x - (b.x - a.x) * a.y;
+
+        // Exactly one of two triangles sharing an edge takes its pixels
+        t.tieInside[i] = t.a[i] > 0.0f || (t.a[i] == 0.0f && t.b[i] > 0.0f);
+
+        t.color[i] = colors[order[i]];
+        t.local[i] = local[order[i]];
+
+        lo = glm::min(lo, screen[i]);
+        hi = glm::max(hi, screen[i]);
+    }
+
+    t.invArea = 1.0f / area;
+    t.sdf = sdf;
+
+    lo = glm::clamp(lo, glm::vec2(0.0f), glm::vec2((float)width, (float)height));
+    hi = glm::clamp(hi, glm::vec2(0.0f), glm::vec2((float)width, (float)height));
+    t.minX = (int)std::floor(lo.x);
+    t.minY = (int)std::floor(lo.y);
+    t.maxX = (int)std::ceil(hi.x);
+    t.maxY = (int)std::ceil(hi.y);
+
+    if (t.minX >= t.maxX || t.minY >= t.maxY) {
+        return;
+    }
+
+    const uint32_t index = (uint32_t)triangles.size();
+    triangles.push_back(t);
+
+    for (int ty = t.minY / kTile; ty <= (t.maxY - 1) / kTile; ++ty) {
+        for (int tx = t.minX / kTile; tx <= (t.maxX - 1) / kTile; ++tx) {
+            bins[(size_t)ty * tilesX + tx].push_back(index);
+            stats.binnedTriangles++;
+        }
+    }
+}
+
+void SoftwareRasterizer::rasterizeTile(int tile) {
+    SCED_PROFILE_SCOPE("SoftwareRasterizer::tile");
+
+    using F = Simd::F;
+    using M = Simd::M;
+    constexpr int W = Simd::width;
+
+    const int tileX = (tile % tilesX) * kTile;
+    const int tileY = (tile / tilesX) * kTile;
+    const F ramp = Simd::add(Simd::ramp(), Simd::set(0.5f));
+
+    for (uint32_t index : bins[tile]) {
+        const Triangle& t = triangles[index];
+
+        // Spans start on a vector boundary; tiles are whole vectors wide
+        const int x0 = std::max(t.minX, tileX) & ~(W - 1);
+        const int x1 = std::min(t.maxX, tileX + kTile);
+        const int y0 = std::max(t.minY, tileY);
+        const int y1 = std::min(t.maxY, tileY + kTile);
+
+        const F a0 = Simd::set(t.a[0]), a1 = Simd::set(t.a[1]), a2 = Simd::set(t.a[2]);
+        const bool analytic = t.sdf.w > 0.5f;
+
+        // Weights times vertex colors, folded per channel: c = sum(w_i * k_i)
+        F kr[3], kg[3], kb[3];
+        for (int i = 0; i < 3; ++i) {
+            kr[i] = Simd::set(t.color[i].r * t.invArea);
+            kg[i] = Simd::set(t.color[i].g * t.invArea);
+            kb[i] = Simd::set(t.color[i].b * t.invArea);
+        }
+
+        // Shape-space step per pixel, standing in for fwidth()
+        glm::vec2 localDx(0.0f), localDy(0.0f);
+        if (analytic) {
+            for (int i = 0; i < 3; ++i) {
+                localDx += t.local[i] * (t.a[i] * t.invArea);
+                localDy += t.local[i] * (t.b[i] * t.invArea);
+            }
+        }
+
+        for (int y = y0; y < y1; ++y) {
+            const float py = (float)y + 0.5f;
+            const F r0 = Simd::set(t.b[0] * py + t.c[0]);
+            const F r1 = Simd::set(t.b[1] * py + t.c[1]);
+            const F r2 = Simd::set(t.b[2] * py + t.c[2]);
+            uint32_t* row = color.data() + (size_t)y * stride;
+
+            for (int x = x0; x < x1; x += W) {
+                const F px = Simd::add(ramp, Simd::set((float)x));
+                const F w0 = Simd::add(Simd::mul(a0, px), r0);
+                const F w1 = Simd::add(Simd::mul(a1, px), r1);
+                const F w2 = Simd::add(Simd::mul(a2, px), r2);
+
+                const M covered = Simd::both(Simd::both(Simd::inside(w0, t.tieInside[0]),
+                                                        Simd::inside(w1, t.tieInside[1])),
+                                             Simd::inside(w2, t.tieInside[2]));
+                const int bits = Simd::bits(covered);
+
+                if (!bits) {
+                    continue;
+                }
+
+                if (!analytic) {
+                    const F r = Simd::add(Simd::add(Simd::mul(w0, kr[0]), Simd::mul(w1, kr[1])), Simd::mul(w2, kr[2]));
+                    const F g = Simd::add(Simd::add(Simd::mul(w0, kg[0]), Simd::mul(w1, kg[1])), Simd::mul(w2, kg[2]));
+                    const F b = Simd::add(Simd::add(Simd::mul(w0, kb[0]), Simd::mul(w1, kb[1])), Simd::mul(w2, kb[2]));
+                    Simd::write(row + x, covered, Simd::pack(r, g, b));
+                    continue;
+                }
+
+                // Primitive edges: per pixel, as in flat.frag
+                float e[3][W];
+                Simd::store(e[0], w0);
+                Simd::store(e[1], w1);
+                Simd::store(e[2], w2);
+
+                for (int lane = 0; lane < W; ++lane) {
+                    if (!(bits & (1 << lane))) continue;
+
+                    const float b0 = e[0][lane] * t.invArea, b1 = e[1][lane] * t.invArea, b2 = e[2][lane] * t.invArea;
+                    const glm::vec2 p = t.local[0] * b0 + t.local[1] * b1 + t.local[2] * b2;
+
+                    const float d = sdf(t.sdf, p);
+                    const float fw = std::fabs(sdf(t.sdf, p + localDx) - d) + std::fabs(sdf(t.sdf, p + localDy) - d);
+                    const float alpha = glm::clamp(-d / std::max(fw, 1e-6f), 0.0f, 1.0f);
+
+                    if (alpha <= 0.0f) continue;
+
+                    glm::vec4 src(t.color[0] * b0 + t.color[1] * b1 + t.color[2] * b2, alpha);
+                    uint32_t& dst = row[x + lane];
+
+                    if (blending) {
+                        const glm::vec4 old = unpackPixel(dst);
+                        src = glm::vec4(glm::vec3(src) * alpha + glm::vec3(old) * (1.0f - alpha),
+                                        alpha + old.a * (1.0f - alpha));
+                    }
+
+                    dst = packPixel(src);
+                }
+            }
+        }
+    }
+}
+
+void SoftwareRasterizer::readPixels(std::vector<uint8_t>& out) const {
+    out.resize((size_t)width * height * 4);
+
+    for (int y = 0; y < height; ++y) {
+        const uint32_t* row = color.data() + (size_t)y * stride;
+        uint8_t* dst = out.data() + (size_t)y * width * 4;
+
+        for (int x = 0; x < width; ++x) {
+            dst[x * 4 + 0] = (uint8_t)(row[x] & 0xFF);
+            dst[x * 4 + 1] = (uint8_t)((row[x] >> 8) & 0xFF);
+            dst[x * 4 + 2] = (uint8_t)((row[x] >> 16) & 0xFF);
+            dst[x * 4 + 3] = (uint8_t)(row[x] >> 24);
+        }
+    }
+}
+
+bool SoftwareRasterizer::savePpm(const std::string& path) const {
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        return false;
+    }
+
+    std::fprintf(f, "P6\n%d %d\n255\n", width, height);
+    for (int y = 0; y < height; ++y) {
+        const uint32_t* row = color.data() + (size_t)y * stride;
+
+        for (int x = 0; x < width; ++x) {
+            const uint8_t rgb[3] = { (uint8_t)(row[x] & 0xFF), (uint8_t)((row[x] >> 8) & 0xFF),
+                                     (uint8_t)((row[x] >> 16) & 0xFF) };
+            std::fwrite(rgb, 1, 3, f);
+        }
+    }
+
+    return std::fclose(f) == 0;
+}
@@ -0,0 +1,248 @@
+#include "SpatialIndex.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Fat boxes grow by a tenth of their size (and never by nothing), so a
+    // shape can drift that far before its leaf has to be reinserted
+    Aabb2D fatten(const Aabb2D& box) {
+        glm::vec2 extent = box.max - box.min;
+        glm::vec2 margin = glm::max(extent * 0.1f, glm::vec2(1e-4f));
+        return { box.min - margin, box.max + margin };
+    }
+
+    bool containsBox(const Aabb2D& outer, const Aabb2D& inner) {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y &&
+               inner.max.x <= outer.max.x && inner.max.y <= outer.max.y;
+    }
+}
+
+int SpatialIndex::insert(uint32_t item, const Aabb2D& box) {
+    const int leaf = allocateNode();
+
+    nodes[leaf].box = fatten(box);
+    nodes[leaf].item = item;
+    nodes[leaf].height = 0;
+
+    insertLeaf(leaf);
+    leaves++;
+
+    return leaf;
+}
+
+void SpatialIndex::remove(int proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    leaves--;
+}
+
+bool SpatialIndex::move(int proxy, const Aabb2D& box) {
+    if (containsBox(nodes[proxy].box, box)) {
+        return false;
+    }
+
+    removeLeaf(proxy);
+    nodes[proxy].box = fatten(box);
+    insertLeaf(proxy);
+
+    return true;
+}
+
+void SpatialIndex::clear() {
+    nodes.clear();
+    root = null;
+    freeList = null;
+    leaves = 0;
+}
+
+int SpatialIndex::allocateNode() {
+    if (freeList == null) {
+        nodes.emplace_back();
+        return (int)nodes.size() - 1;
+    }
+
+    const int id = freeList;
+    freeList = nodes[id].parent;
+
+    nodes[id] = Node{};
+    return id;
+}
+
+void SpatialIndex::freeNode(int node) {
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+void SpatialIndex::insertLeaf(int leaf) {
+    if (root == null) {
+        root = leaf;
+        nodes[leaf].parent = null;
+        return;
+    }
+
+    // Walk down towards the sibling whose merge adds the least perimeter
+    const Aabb2D leafBox = nodes[leaf].box;
+    int index = root;
+
+    while (!nodes[index].leaf()) {
+        const Node& n = nodes[index];
+        const int c1 = n.child1;
+        const int c2 = n.child2;
+
+        const float area = perimeter(n.box);
+        const float combined = perimeter(merge(n.box, leafBox));
+
+        // Cost of pairing with this node, and the minimum cost pushed down
+        const float cost = 2.0f * combined;
+        const float inherited = 2.0f * (combined - area);
+
+        auto descendCost = [&](int child) {
+            const Aabb2D box = merge(leafBox, nodes[child].box);
+            if (nodes[child].leaf()) {
+                return perimeter(box) + inherited;
+            }
+            return perimeter(box) - perimeter(nodes[child].box) + inherited;
+        };
+
+        const float cost1 = descendCost(c1);
+        const float cost2 = descendCost(c2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+
+        index = cost1 < cost2 ? c1 : c2;
+    }
+
+    const int sibling = index;
+
+    // New parent takes the sibling's place
+    const int oldParent = nodes[sibling].parent;
+    const int newParent = allocateNode();
+
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box = merge(leafBox, nodes[sibling].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == null) {
+        root = newParent;
+    } else if (nodes[oldParent].child1 == sibling) {
+        nodes[oldParent].child1 = newParent;
+    } else {
+        nodes[oldParent].child2 = newParent;
+    }
+
+    // Refit and rebalance up to the root
+    index = nodes[leaf].parent;
+    while (index != null) {
+        index = balance(index);
+
+        Node& n = nodes[index];
+        n.height = 1 + std::max(nodes[n.child1].height, nodes[n.child2].height);
+        n.box = merge(nodes[n.child1].box, nodes[n.child2].box);
+
+        index = n.parent;
+    }
+}
+
+void SpatialIndex::removeLeaf(int leaf) {
+    if (leaf == root) {
+        root = null;
+        return;
+    }
+
+    // The sibling replaces the parent, which is freed
+    const int parent = nodes[leaf].parent;
+    const int grandParent = nodes[parent].parent;
+    const int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent == null) {
+        root = sibling;
+        nodes[sibling].parent = null;
+        freeNode(parent);
+        return;
+    }
+
+    if (nodes[grandParent].child1 == parent) {
+        nodes[grandParent].child1 = sibling;
+    } else {
+        nodes[grandParent].child2 = sibling;
+    }
+
+    nodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    int index = grandParent;
+    while (index != null) {
+        index = balance(index);
+
+        Node& n = nodes[index];
+        n.box = merge(nodes[n.child1].box, nodes[n.child2].box);
+        n.height = 1 + std::max(nodes[n.child1].height, nodes[n.child2].height);
+
+        index = n.parent;
+    }
+}
+
+// If one child of a is two levels taller than the other, rotate it up.
+// Returns the node now in a's place.
+int SpatialIndex::balance(int a) {
+    Node& A = nodes[a];
+    if (A.leaf() || A.height < 2) {
+        return a;
+    }
+
+    const int b = A.child1;
+    const int c = A.child2;
+    const int diff = nodes[c].height - nodes[b].height;
+
+    if (diff > 1 || diff < -1) {
+        // Rotate the taller child (up) above a
+        const int up = diff > 1 ? c : b;
+        const int other = diff > 1 ? b : c;
+
+        Node& U = nodes[up];
+        const int f = U.child1;
+        const int g = U.child2;
+
+        U.child1 = a;
+        U.parent = A.parent;
+        A.parent = up;
+
+        if (U.parent == null) {
+            root = up;
+        } else if (nodes[U.parent].child1 == a) {
+            nodes[U.parent].child1 = up;
+        } else {
+            nodes[U.parent].child2 = up;
+        }
+
+        // The taller grandchild stays under up, the shorter one moves to a
+        const int keep = nodes[f].height > nodes[g].height ? f : g;
+        const int give = keep == f ? g : f;
+
+        U.child2 = keep;
+        if (diff > 1) {
+            A.child2 = give;
+        } else {
+            A.child1 = give;
+        }
+        nodes[give].parent = a;
+
+        A.box = merge(nodes[other].box, nodes[give].box);
+        U.box = merge(A.box, nodes[keep].box);
+
+        A.height = 1 + std::max(nodes[other].height, nodes[give].height);
+        U.height = 1 + std::max(A.height, nodes[keep].height);
+
+        return up;
+    }
+
+    return a;
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+#include "Aabb2D.hpp"
+
+// Dynamic AABB tree over boxes tagged with a user value. Leaves store the
+// box grown by a margin, so small moves do not touch the tree; inserts pick
+// the sibling that grows the tree least and rotations keep it balanced.
+// Queries return every item whose stored (fat) box matches, callers test
+// their exact bounds.
+class SpatialIndex {
+public:
+    static constexpr int null = -1;
+
+    // Returns a proxy id for move() and remove()
+    int insert(uint32_t item, const Aabb2D& box);
+    void remove(int proxy);
+    // Re-inserts only when box has left the fat box; returns true if it did
+    bool move(int proxy, const Aabb2D& box);
+
+    uint32_t item(int proxy) const { return nodes[proxy].item; }
+    const Aabb2D& fatBox(int proxy) const { return nodes[proxy].box; }
+
+    void clear();
+    size_t size() const { return leaves; }
+    int height() const { return root == null ? 0 : nodes[root].height; }
+
+    // fn(proxy) for every leaf whose fat box contains p / touches box.
+    // Callbacks must not query the same index again.
+    template <typename Fn>
+    void queryPoint(glm::vec2 p, Fn&& fn) const {
+        query([&](const Aabb2D& b) {
+            return p.x >= b.min.x && p.x <= b.max.x && p.y >= b.min.y && p.y <= b.max.y;
+        }, fn);
+    }
+
+    template <typename Fn>
+    void queryRect(const Aabb2D& box, Fn&& fn) const {
+        query([&](const Aabb2D& b) { return b.intersects(box); }, fn);
+    }
+
+    // Best-first search. distance(proxy) returns the exact distance for a
+    // leaf (FLT_MAX to skip it); subtrees whose fat box is already farther
+    // than the best hit are never opened. Returns null if nothing is within
+    // maxDistance.
+    template <typename Fn>
+    int nearest(glm::vec2 p, float maxDistance, Fn&& distance) const;
+
+    static float distance(const Aabb2D& b, glm::vec2 p) {
+        glm::vec2 d = glm::max(glm::max(b.min - p, p - b.max), glm::vec2(0.0f));
+        return glm::length(d);
+    }
+
+private:
+    struct Node {
+        Aabb2D box;
+        int parent = null;      // next free node while on the free list
+        int child1 = null;
+        int child2 = null;
+        int height = 0;         // 0 for leaves, -1 for free nodes
+        uint32_t item = 0;
+
+        bool leaf() const { return child1 == null; }
+    };
+
+    std::vector<Node> nodes;
+    int root{null};
+    int freeList{null};
+    size_t leaves{0};
+    mutable std::vector<int> stack;
+
+    int allocateNode();
+    void freeNode(int node);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int node);
+
+    static Aabb2D merge(const Aabb2D& a, const Aabb2D& b) {
+        Aabb2D out = a;
+        out.expand(b);
+        return out;
+    }
+
+    static float perimeter(const Aabb2D& b) {
+        return 2.0f * ((b.max.x - b.min.x) + (b.max.y - b.min.y));
+    }
+
+    template <typename Test, typename Fn>
+    void query(Test&& test, Fn& fn) const {
+        if (root == null) return;
+
+        stack.clear();
+        stack.push_back(root);
+
+        while (!stack.empty()) {
+            const int id = stack.back();
+            stack.pop_back();
+
+            const Node& n = nodes[id];
+            if (!test(n.box)) continue;
+
+            if (n.leaf()) {
+                fn(id);
+            } else {
+                stack.push_back(n.child1);
+                stack.push_back(n.child2);
+            }
+        }
+    }
+};
+
+template <typename Fn>
+int SpatialIndex::nearest(glm::vec2 p, float maxDistance, Fn&& exact) const {
+    int best = null;
+    float bestDistance = maxDistance;
+
+    if (root == null) return best;
+
+    // Depth first, nearer child on top, pruned by the best hit so far
+    stack.clear();
+    stack.push_back(root);
+
+    while (!stack.empty()) {
+        const int id = stack.back();
+        stack.pop_back();
+
+        // Once there is a hit, ties cannot improve on it
+        const Node& n = nodes[id];
+        const float boxDistance = distance(n.box, p);
+        if (boxDistance > bestDistance || (best != null && boxDistance == bestDistance)) continue;
+
+        if (n.leaf()) {
+            float d = exact(id);
+            if (d <= bestDistance) {
+                best = id;
+                bestDistance = d;
+            }
+            continue;
+        }
+
+        float d1 = distance(nodes[n.child1].box, p);
+        float d2 = distance(nodes[n.child2].box, p);
+
+        if (d1 < d2) {
+            stack.push_back(n.child2);
+            stack.push_back(n.child1);
+        } else {
+            stack.push_back(n.child1);
+            stack.push_back(n.child2);
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,100 @@
+#include "StagingQueue.hpp"
+#include <algorithm>
+
+StagingQueue::StagingQueue(SlotMap<ShapeRecord, ShapeHandle>& shapes, size_t blockVertices)
+    : shapes(shapes), blockVertices(blockVertices) {}
+
+StagingQueue::~StagingQueue() {
+    for (Block* block : takeAll()) {
+        delete block;
+    }
+}
+
+void StagingQueue::publish(Block* block) {
+    // Treiber push; the consumer only ever takes the whole list, so there is
+    // no pop to race with and no ABA
+    Block* expected = head.load(std::memory_order_relaxed);
+    do {
+        block->next = expected;
+    } while (!head.compare_exchange_weak(expected, block, std::memory_order_release, std::memory_order_relaxed));
+}
+
+std::vector<StagingQueue::Block*> StagingQueue::takeAll() {
+    std::vector<Block*> blocks;
+
+    for (Block* block = head.exchange(nullptr, std::memory_order_acquire); block; block = block->next) {
+        blocks.push_back(block);
+    }
+
+    // The list is newest first
+    std::reverse(blocks.begin(), blocks.end());
+    return blocks;
+}
+
+StagingQueue::Writer::Writer(StagingQueue& queue) : queue(queue) {}
+
+StagingQueue::Writer::~Writer() {
+    flush();
+}
+
+ShapeHandle StagingQueue::Writer::addShape(const Vertex2D* verts, int count, const glm::mat4& model) {
+    return addShape(verts, count, nullptr, 0, model);
+}
+
+ShapeHandle StagingQueue::Writer::addShape(const Mesh2D& mesh, const glm::mat4& model) {
+    return addShape(mesh.vertices.data(), (int)mesh.vertices.size(),
+                    mesh.indices.data(), (int)mesh.indices.size(), model);
+}
+
+ShapeHandle StagingQueue::Writer::addShape(const Vertex2D* verts, int count, const uint32_t* indices,
+                                           int indexCount, const glm::mat4& model)
+{
+    if (count <= 0 || (indices && indexCount <= 0)) {
+        return {};
+    }
+
+    if (!block) {
+        block = new Block();
+    }
+
+    Command command{};
+    command.handle = queue.shapes.reserve();
+    command.model = model;
+    command.vertexOffset = (int)block->vertices.size();
+    command.vertexCount = count;
+    command.indexOffset = (int)block->indices.size();
+    command.indexCount = indices ? indexCount : 0;
+
+    block->vertices.insert(block->vertices.end(), verts, verts + count);
+    if (indices) {
+        block->indices.insert(block->indices.end(), indices, indices + indexCount);
+    }
+    block->commands.push_back(command);
+
+    if (block->vertices.size() >= queue.blockVertices) {
+        flush();
+    }
+
+    return command.handle;
+}
+
+void StagingQueue::Writer::setModel(ShapeHandle handle, const glm::mat4& model) {
+    if (!block) {
+        block = new Block();
+    }
+
+    Command command{};
+    command.handle = handle;
+    command.model = model;
+    block->commands.push_back(command);
+}
+
+void StagingQueue::Writer::flush() {
+    if (block && !block->commands.empty()) {
+        queue.publish(block);
+        block = nullptr;
+    }
+
+    delete block;
+    block = nullptr;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Vertex2D.hpp"
+#include "Mesh2D.hpp"
+#include "ShapeRecord.hpp"
+#include "ShapeHandle.hpp"
+#include "SlotMap.hpp"
+
+// Geometry built off the GL thread. Each producer thread writes into its own
+// Writer, which fills a private block and publishes it with one CAS onto a
+// lock-free list; Renderer2D takes the whole list at beginFrame() and commits
+// it in one batch. Handles are reserved up front, so a producer can keep
+// them, but they only become valid once their block has been committed.
+class StagingQueue {
+public:
+    struct Block;
+
+    // Not thread-safe itself: one per producer thread, flushed on destruction.
+    // Commands from one writer are committed in the order they were made.
+    class Writer {
+    public:
+        explicit Writer(StagingQueue& queue);
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        ShapeHandle addShape(const Vertex2D* verts, int count, const glm::mat4& model = glm::mat4(1.0f));
+        ShapeHandle addShape(const Vertex2D* verts, int count, const uint32_t* indices, int indexCount,
+                             const glm::mat4& model = glm::mat4(1.0f));
+        ShapeHandle addShape(const Mesh2D& mesh, const glm::mat4& model = glm::mat4(1.0f));
+
+        // For shapes staged earlier or already live; stale handles are skipped at commit
+        void setModel(ShapeHandle handle, const glm::mat4& model);
+
+        // Publish what has been staged so far (done automatically when a
+        // block fills up)
+        void flush();
+
+    private:
+        StagingQueue& queue;
+        Block* block{nullptr};
+    };
+
+    struct Command {
+        ShapeHandle handle;
+        glm::mat4 model;
+        int vertexOffset;       // into the block's vertices
+        int vertexCount;        // 0 for a model update
+        int indexOffset;
+        int indexCount;         // 0 for a plain triangle list
+    };
+
+    struct Block {
+        std::vector<Vertex2D> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<Command> commands;
+        Block* next{nullptr};
+    };
+
+    explicit StagingQueue(SlotMap<ShapeRecord, ShapeHandle>& shapes, size_t blockVertices = 1 << 16);
+    ~StagingQueue();
+
+    StagingQueue(const StagingQueue&) = delete;
+    StagingQueue& operator=(const StagingQueue&) = delete;
+
+    // Consumer side: every published block, oldest first; the caller deletes them
+    std::vector<Block*> takeAll();
+
+private:
+    SlotMap<ShapeRecord, ShapeHandle>& shapes;
+    size_t blockVertices;
+    std::atomic<Block*> head{nullptr};
+
+    void publish(Block* block);
+};
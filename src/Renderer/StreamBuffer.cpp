@@ -0,0 +1,87 @@
+#include "StreamBuffer.hpp"
+#include "GLState.hpp"
+#include <algorithm>
+#include <cstring>
+
+StreamBuffer::StreamBuffer(size_t segmentBytes, int segments)
+    : segmentBytes(segmentBytes), segmentCount(std::clamp(segments, 2, 8))
+{
+    glGenBuffers(1, &buffer);
+    GLState::bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)(segmentBytes * segmentCount), nullptr, GL_STREAM_DRAW);
+    GLState::bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (GLsync& f : fences) {
+        if (f) glDeleteSync(f);
+    }
+
+    if (buffer) {
+        GLState::deleteBuffers(1, &buffer);
+    }
+}
+
+GLintptr StreamBuffer::write(const void* data, size_t bytes, size_t align) {
+    if (bytes == 0 || bytes > segmentBytes - align) {
+        return -1;
+    }
+
+    const size_t base = (size_t)current * segmentBytes;
+    size_t offset = (base + head + align - 1) / align * align;
+
+    // Out of room this frame: start on the next segment early
+    if (offset + bytes > base + segmentBytes) {
+        advance();
+        const size_t next = (size_t)current * segmentBytes;
+        offset = (next + align - 1) / align * align;
+    }
+
+    GLState::bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    void* dst = glMapBufferRange(GL_COPY_WRITE_BUFFER, (GLintptr)offset, (GLsizeiptr)bytes,
+                                 GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    if (!dst) {
+        return -1;
+    }
+
+    std::memcpy(dst, data, bytes);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+
+    head = offset + bytes - (size_t)current * segmentBytes;
+    streamed += bytes;
+    return (GLintptr)offset;
+}
+
+void StreamBuffer::nextFrame() {
+    // Nothing written this frame, the segment can simply be reused
+    if (head == 0) {
+        return;
+    }
+
+    advance();
+}
+
+void StreamBuffer::advance() {
+    if (fences[current]) glDeleteSync(fences[current]);
+    fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    current = (current + 1) % segmentCount;
+    head = 0;
+
+    GLsync& f = fences[current];
+    if (!f) {
+        return;
+    }
+
+    // Poll first so only real stalls are counted
+    GLenum status = glClientWaitSync(f, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        ++waits;
+        while (status == GL_TIMEOUT_EXPIRED) {
+            status = glClientWaitSync(f, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        }
+    }
+
+    glDeleteSync(f);
+    f = nullptr;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <glad/glad.h>
+
+// Ring of per-frame segments inside one GL buffer. Writes go through
+// glMapBufferRange with UNSYNCHRONIZED | INVALIDATE_RANGE, so the driver never
+// stalls on them; instead each segment is fenced when the frame moves on and
+// the CPU only waits if it laps a segment the GPU has not finished reading.
+class StreamBuffer {
+public:
+    explicit StreamBuffer(size_t segmentBytes = 1 << 20, int segments = 3);
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Copy bytes into the current segment and return their buffer offset
+    // (a multiple of align), or -1 if they can never fit in one segment
+    GLintptr write(const void* data, size_t bytes, size_t align = 4);
+
+    // Fence the segment used this frame and move to the next one
+    void nextFrame();
+
+    GLuint id() const { return buffer; }
+    size_t segmentSize() const { return segmentBytes; }
+
+    // Counters since the last resetCounters()
+    uint32_t fenceWaits() const { return waits; }
+    uint64_t bytesStreamed() const { return streamed; }
+    void resetCounters() { waits = 0; streamed = 0; }
+
+private:
+    GLuint buffer{0};
+    size_t segmentBytes;
+    int segmentCount;
+    int current{0};
+    size_t head{0};              // write position inside the current segment
+    GLsync fences[8]{};
+
+    uint32_t waits{0};
+    uint64_t streamed{0};
+
+    void advance();
+};
@@ -0,0 +1,214 @@
+#include "StrokeBuilder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+    constexpr float pi = 3.14159265358979f;
+
+    float angleOf(glm::vec2 v) {
+        return std::atan2(v.y, v.x);
+    }
+}
+
+void StrokeBuilder::begin(glm::vec2 point, float r, const glm::vec3& c) {
+    radius = r;
+    color = c;
+
+    points.clear();
+    points.push_back(point);
+
+    live = Mesh2D{};
+    addEndCap();
+}
+
+bool StrokeBuilder::addPoint(glm::vec2 point) {
+    if (points.empty()) {
+        return false;
+    }
+
+    // Sub-pixel mouse jitter only adds vertices
+    if (glm::distance(point, points.back()) < radius * 0.25f) {
+        return false;
+    }
+
+    dropEndCap();
+
+    // The start cap can only be oriented once there is a direction
+    if (points.size() == 1) {
+        glm::vec2 d = glm::normalize(point - points[0]);
+        addArc(live, points[0], radius, angleOf(d) + pi * 0.5f, pi, capSegments, color);
+    } else {
+        addJoin(live, points[points.size() - 2], points.back(), point, radius, capSegments, color);
+    }
+
+    addSegment(live, points.back(), point, radius, color);
+    points.push_back(point);
+
+    addEndCap();
+    return true;
+}
+
+Mesh2D StrokeBuilder::finish(float tolerance) {
+    if (tolerance < 0.0f) {
+        tolerance = radius * 0.125f;
+    }
+
+    Mesh2D mesh = build(simplify(points, tolerance), radius, color, capSegments);
+
+    points.clear();
+    live = Mesh2D{};
+    capVertices = capIndices = 0;
+
+    return mesh;
+}
+
+void StrokeBuilder::dropEndCap() {
+    live.vertices.resize(live.vertices.size() - capVertices);
+    live.indices.resize(live.indices.size() - capIndices);
+    capVertices = capIndices = 0;
+}
+
+void StrokeBuilder::addEndCap() {
+    const size_t vertices = live.vertices.size();
+    const size_t indices = live.indices.size();
+
+    if (points.size() == 1) {
+        // A single click is a dot
+        addArc(live, points[0], radius, 0.0f, 2.0f * pi, capSegments, color);
+    } else {
+        glm::vec2 d = glm::normalize(points.back() - points[points.size() - 2]);
+        addArc(live, points.back(), radius, angleOf(d) - pi * 0.5f, pi, capSegments, color);
+    }
+
+    capVertices = live.vertices.size() - vertices;
+    capIndices = live.indices.size() - indices;
+}
+
+std::vector<glm::vec2> StrokeBuilder::simplify(const std::vector<glm::vec2>& path, float tolerance) {
+    if (path.size() < 3) {
+        return path;
+    }
+
+    std::vector<bool> keep(path.size(), false);
+    keep.front() = keep.back() = true;
+
+    // Iterative, so long strokes cannot overflow the stack
+    std::vector<std::pair<size_t, size_t>> spans{{0, path.size() - 1}};
+
+    while (!spans.empty()) {
+        auto [first, last] = spans.back();
+        spans.pop_back();
+
+        glm::vec2 a = path[first];
+        glm::vec2 ab = path[last] - a;
+        float length = glm::length(ab);
+
+        float worst = 0.0f;
+        size_t worstIndex = first;
+
+        for (size_t i = first + 1; i < last; ++i) {
+            glm::vec2 ap = path[i] - a;
+            float d = length > 0.0f ? std::abs(ab.x * ap.y - ab.y * ap.x) / length : glm::length(ap);
+
+            if (d > worst) {
+                worst = d;
+                worstIndex = i;
+            }
+        }
+
+        if (worst > tolerance) {
+            keep[worstIndex] = true;
+            spans.push_back({first, worstIndex});
+            spans.push_back({worstIndex, last});
+        }
+    }
+
+    std::vector<glm::vec2> out;
+    for (size_t i = 0; i < path.size(); ++i) {
+        if (keep[i]) out.push_back(path[i]);
+    }
+
+    return out;
+}
+
+Mesh2D StrokeBuilder::build(const std::vector<glm::vec2>& path, float radius, const glm::vec3& color,
+                            int capSegments)
+{
+    Mesh2D mesh;
+
+    if (path.empty()) {
+        return mesh;
+    }
+
+    if (path.size() == 1) {
+        addArc(mesh, path[0], radius, 0.0f, 2.0f * pi, capSegments, color);
+        return mesh;
+    }
+
+    glm::vec2 first = glm::normalize(path[1] - path[0]);
+    addArc(mesh, path[0], radius, angleOf(first) + pi * 0.5f, pi, capSegments, color);
+
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        if (i > 0) {
+            addJoin(mesh, path[i - 1], path[i], path[i + 1], radius, capSegments, color);
+        }
+        addSegment(mesh, path[i], path[i + 1], radius, color);
+    }
+
+    glm::vec2 last = glm::normalize(path.back() - path[path.size() - 2]);
+    addArc(mesh, path.back(), radius, angleOf(last) - pi * 0.5f, pi, capSegments, color);
+
+    return mesh;
+}
+
+void StrokeBuilder::addArc(Mesh2D& mesh, glm::vec2 center, float radius, float from, float sweep,
+                           int capSegments, const glm::vec3& color)
+{
+    // Fan around the center, capSegments triangles per half turn
+    const int steps = std::max(1, (int)std::ceil(std::abs(sweep) / pi * capSegments));
+    const uint32_t base = (uint32_t)mesh.vertices.size();
+
+    mesh.vertices.push_back({ center, color });
+    for (int i = 0; i <= steps; ++i) {
+        float a = from + sweep * (float)i / (float)steps;
+        mesh.vertices.push_back({ center + radius * glm::vec2(std::cos(a), std::sin(a)), color });
+    }
+
+    for (int i = 0; i < steps; ++i) {
+        mesh.indices.push_back(base);
+        mesh.indices.push_back(base + 1 + i);
+        mesh.indices.push_back(base + 2 + i);
+    }
+}
+
+void StrokeBuilder::addSegment(Mesh2D& mesh, glm::vec2 a, glm::vec2 b, float radius, const glm::vec3& color) {
+    glm::vec2 d = glm::normalize(b - a);
+    glm::vec2 n = glm::vec2(-d.y, d.x) * radius;
+    const uint32_t base = (uint32_t)mesh.vertices.size();
+
+    mesh.vertices.push_back({ a + n, color });
+    mesh.vertices.push_back({ a - n, color });
+    mesh.vertices.push_back({ b - n, color });
+    mesh.vertices.push_back({ b + n, color });
+
+    for (uint32_t i : { 0u, 1u, 2u, 0u, 2u, 3u }) {
+        mesh.indices.push_back(base + i);
+    }
+}
+
+void StrokeBuilder::addJoin(Mesh2D& mesh, glm::vec2 prev, glm::vec2 at, glm::vec2 next, float radius,
+                            int capSegments, const glm::vec3& color)
+{
+    glm::vec2 d0 = glm::normalize(at - prev);
+    glm::vec2 d1 = glm::normalize(next - at);
+
+    float turn = std::atan2(d0.x * d1.y - d0.y * d1.x, glm::dot(d0, d1));
+    if (std::abs(turn) < 1e-3f) {
+        return;
+    }
+
+    // The gap opens on the outside of the bend: right side for a left turn
+    float side = turn > 0.0f ? -0.5f * pi : 0.5f * pi;
+    addArc(mesh, at, radius, angleOf(d0) + side, turn, capSegments, color);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+#include "Mesh2D.hpp"
+
+// Turns a cursor path into one indexed mesh: a quad per segment, round
+// joins on the outer side of each bend and round caps at both ends.
+// The mesh grows as points arrive (only the end cap is rebuilt), and
+// finish() simplifies the path so the stored stroke scales with how curvy
+// it is, not with how often the mouse was sampled.
+class StrokeBuilder {
+public:
+    // capSegments: triangles per half circle for caps and joins
+    explicit StrokeBuilder(int capSegments = 8) : capSegments(capSegments) {}
+
+    void begin(glm::vec2 point, float radius, const glm::vec3& color);
+
+    // Returns false when the point is too close to the last one to matter
+    bool addPoint(glm::vec2 point);
+
+    bool active() const { return !points.empty(); }
+    const std::vector<glm::vec2>& path() const { return points; }
+
+    // Live geometry for the stroke so far
+    const Mesh2D& mesh() const { return live; }
+
+    // Simplify the path (tolerance in world units, default radius / 8), build
+    // the final mesh and reset the builder
+    Mesh2D finish(float tolerance = -1.0f);
+
+    // Ramer-Douglas-Peucker
+    static std::vector<glm::vec2> simplify(const std::vector<glm::vec2>& path, float tolerance);
+    static Mesh2D build(const std::vector<glm::vec2>& path, float radius, const glm::vec3& color,
+                        int capSegments = 8);
+
+private:
+    int capSegments;
+    float radius{0.0f};
+    glm::vec3 color{0.0f};
+
+    std::vector<glm::vec2> points;
+    Mesh2D live;
+    size_t capVertices{0};      // the end cap sits at the tail of live
+    size_t capIndices{0};
+
+    void dropEndCap();
+    void addEndCap();
+
+    static void addArc(Mesh2D& mesh, glm::vec2 center, float radius, float from, float sweep,
+                       int capSegments, const glm::vec3& color);
+    static void addSegment(Mesh2D& mesh, glm::vec2 a, glm::vec2 b, float radius, const glm::vec3& color);
+    static void addJoin(Mesh2D& mesh, glm::vec2 prev, glm::vec2 at, glm::vec2 next, float radius,
+                        int capSegments, const glm::vec3& color);
+};
@@ -0,0 +1,153 @@
+#include "VertexAllocator.hpp"
+#include <climits>
+
+int VertexAllocator::allocate(int count, uint32_t owner) {
+    int offset = topOffset;
+
+    // Smallest hole that fits, otherwise grow at the top
+    auto fit = freeBySize.lower_bound({count, INT_MIN});
+
+    if (fit != freeBySize.end()) {
+        const int holeOffset = fit->second;
+        const int holeCount  = fit->first;
+
+        eraseFree(freeByOffset.find(holeOffset));
+        offset = holeOffset;
+
+        if (holeCount > count) {
+            insertFree(holeOffset + count, holeCount - count);
+        }
+    } else {
+        topOffset += count;
+    }
+
+    used[offset] = Block{count, owner};
+    return offset;
+}
+
+void VertexAllocator::free(int offset) {
+    auto it = used.find(offset);
+
+    if (it == used.end()) {
+        return;
+    }
+
+    int start = offset;
+    int count = it->second.count;
+    used.erase(it);
+
+    // Merge with the hole after
+    auto next = freeByOffset.find(start + count);
+    if (next != freeByOffset.end()) {
+        count += next->second;
+        eraseFree(next);
+    }
+
+    // Merge with the hole before
+    auto prev = freeByOffset.lower_bound(start);
+    if (prev != freeByOffset.begin()) {
+        --prev;
+        if (prev->first + prev->second == start) {
+            start = prev->first;
+            count += prev->second;
+            eraseFree(prev);
+        }
+    }
+
+    // A hole touching the top just lowers the top
+    if (start + count == topOffset) {
+        topOffset = start;
+    } else {
+        insertFree(start, count);
+    }
+}
+
+void VertexAllocator::setOwner(int offset, uint32_t owner) {
+    auto it = used.find(offset);
+
+    if (it != used.end()) {
+        it->second.owner = owner;
+    }
+}
+
+int VertexAllocator::compact(int maxVertices, const MoveFn& move) {
+    int moved = 0;
+
+    while (!freeByOffset.empty()) {
+        auto hole = freeByOffset.begin();
+        const int holeOffset = hole->first;
+        const int holeCount  = hole->second;
+
+        // Holes are always coalesced, so a live range starts right after
+        auto block = used.find(holeOffset + holeCount);
+        if (block == used.end()) {
+            break;
+        }
+
+        const Block b = block->second;
+
+        // Always make progress, even if one shape is bigger than the budget
+        if (moved > 0 && moved + b.count > maxVertices) {
+            break;
+        }
+
+        eraseFree(hole);
+        used.erase(block);
+        used[holeOffset] = b;
+
+        move(b.owner, holeOffset + holeCount, holeOffset, b.count);
+
+        moved += b.count;
+        ++moves;
+        movedVertices += b.count;
+
+        // The hole now sits after the moved range
+        int start = holeOffset + b.count;
+        int count = holeCount;
+
+        auto next = freeByOffset.find(start + count);
+        if (next != freeByOffset.end()) {
+            count += next->second;
+            eraseFree(next);
+        }
+
+        if (start + count == topOffset) {
+            topOffset = start;
+        } else {
+            insertFree(start, count);
+        }
+
+        if (moved >= maxVertices) {
+            break;
+        }
+    }
+
+    return moved;
+}
+
+VertexAllocatorStats VertexAllocator::stats() const {
+    VertexAllocatorStats s;
+
+    s.span = topOffset;
+    s.freeVertices = freeTotal;
+    s.liveVertices = topOffset - freeTotal;
+    s.freeRanges = (int)freeByOffset.size();
+    s.largestFree = freeBySize.empty() ? 0 : freeBySize.rbegin()->first;
+    s.fragmentation = freeTotal > 0 ? 1.f - (float)s.largestFree / (float)freeTotal : 0.f;
+    s.compactionMoves = moves;
+    s.compactedVertices = movedVertices;
+
+    return s;
+}
+
+void VertexAllocator::insertFree(int offset, int count) {
+    freeByOffset[offset] = count;
+    freeBySize.insert({count, offset});
+    freeTotal += count;
+}
+
+void VertexAllocator::eraseFree(std::map<int, int>::iterator it) {
+    freeBySize.erase({it->second, it->first});
+    freeTotal -= it->second;
+    freeByOffset.erase(it);
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <utility>
+
+struct VertexAllocatorStats {
+    int span = 0;               // vertices from 0 to the top of the buffer
+    int liveVertices = 0;
+    int freeVertices = 0;       // holes below the top
+    int freeRanges = 0;
+    int largestFree = 0;
+    float fragmentation = 0.f;  // 1 - largestFree / freeVertices (0 = one hole or none)
+
+    uint64_t compactionMoves = 0;       // shapes moved by compact(), lifetime
+    uint64_t compactedVertices = 0;     // vertices copied by compact(), lifetime
+};
+
+// Hands out [offset, offset + count) vertex ranges inside one growing buffer.
+// Freed ranges are coalesced with their neighbours and reused best-fit, so
+// removing a shape never shifts anyone else. compact() slides live ranges
+// down over the holes a bounded amount at a time.
+class VertexAllocator {
+public:
+    // fn(owner, from, to, count): the caller copies the vertices and
+    // points the owner at its new offset
+    using MoveFn = std::function<void(uint32_t owner, int from, int to, int count)>;
+
+    int allocate(int count, uint32_t owner);
+    void free(int offset);
+
+    // Hand a live range to a different owner (reported by compact())
+    void setOwner(int offset, uint32_t owner);
+
+    // Move at most maxVertices vertices; returns how many were moved
+    int compact(int maxVertices, const MoveFn& move);
+
+    // One past the last allocated vertex
+    int top() const { return topOffset; }
+
+    VertexAllocatorStats stats() const;
+
+private:
+    struct Block {
+        int count;
+        uint32_t owner;
+    };
+
+    std::map<int, Block> used;                  // offset -> live range
+    std::map<int, int> freeByOffset;            // offset -> count, for coalescing
+    std::set<std::pair<int, int>> freeBySize;   // (count, offset), for best fit
+    int topOffset = 0;
+    int freeTotal = 0;
+
+    uint64_t moves = 0;
+    uint64_t movedVertices = 0;
+
+    void insertFree(int offset, int count);
+    void eraseFree(std::map<int, int>::iterator it);
+};
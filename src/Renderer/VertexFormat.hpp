@@ -0,0 +1,137 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include "Vertex2D.hpp"
+
+// GPU-side vertex layouts. Shapes are always built as Vertex2D; Renderer2D
+// packs them into GpuVertex when they are added, so only the stored and
+// uploaded copy shrinks. Pick one with -DSCED_VERTEX_FORMAT=<name>:
+//
+//   Full          vec2 pos + vec3 color       20 bytes
+//   Packed        vec2 pos + RGBA8 color      12 bytes (default)
+//   Half          half2 pos + RGBA8 color      8 bytes, ~11 bits of position
+//   PositionOnly  vec2 pos, color per shape    8 bytes, first vertex sets the color
+
+struct PackedVertex2D {
+    glm::vec2 pos;
+    uint8_t color[4];
+};
+
+struct HalfVertex2D {
+    uint16_t pos[2];
+    uint8_t color[4];
+};
+
+struct PositionVertex2D {
+    glm::vec2 pos;
+};
+
+namespace VertexPacking {
+    inline void packColor(const glm::vec3& c, uint8_t out[4]) {
+        glm::u8vec4 v = glm::u8vec4(glm::round(glm::clamp(glm::vec4(c, 1.0f), 0.0f, 1.0f) * 255.0f));
+        out[0] = v.r; out[1] = v.g; out[2] = v.b; out[3] = v.a;
+    }
+
+    inline glm::vec3 unpackColor(const uint8_t c[4]) {
+        return glm::vec3(c[0], c[1], c[2]) / 255.0f;
+    }
+}
+
+// pack/unpack between Vertex2D and V, and the attribute pointers for
+// locations 0 (position) and 1 (color) with V bound as GL_ARRAY_BUFFER
+template <typename V>
+struct VertexLayout;
+
+template <>
+struct VertexLayout<Vertex2D> {
+    static constexpr bool perShapeColor = false;
+
+    static Vertex2D pack(const Vertex2D& v) { return v; }
+    static Vertex2D unpack(const Vertex2D& v, const glm::vec3&) { return v; }
+
+    static void setupAttributes() {
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2D), (void*)offsetof(Vertex2D, pos));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex2D), (void*)offsetof(Vertex2D, color));
+    }
+};
+
+template <>
+struct VertexLayout<PackedVertex2D> {
+    static constexpr bool perShapeColor = false;
+
+    static PackedVertex2D pack(const Vertex2D& v) {
+        PackedVertex2D p;
+        p.pos = v.pos;
+        VertexPacking::packColor(v.color, p.color);
+        return p;
+    }
+
+    static Vertex2D unpack(const PackedVertex2D& p, const glm::vec3&) {
+        return { p.pos, VertexPacking::unpackColor(p.color) };
+    }
+
+    static void setupAttributes() {
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(PackedVertex2D), (void*)offsetof(PackedVertex2D, pos));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PackedVertex2D), (void*)offsetof(PackedVertex2D, color));
+    }
+};
+
+template <>
+struct VertexLayout<HalfVertex2D> {
+    static constexpr bool perShapeColor = false;
+
+    static HalfVertex2D pack(const Vertex2D& v) {
+        HalfVertex2D p;
+        p.pos[0] = glm::packHalf1x16(v.pos.x);
+        p.pos[1] = glm::packHalf1x16(v.pos.y);
+        VertexPacking::packColor(v.color, p.color);
+        return p;
+    }
+
+    static Vertex2D unpack(const HalfVertex2D& p, const glm::vec3&) {
+        return { glm::vec2(glm::unpackHalf1x16(p.pos[0]), glm::unpackHalf1x16(p.pos[1])),
+                 VertexPacking::unpackColor(p.color) };
+    }
+
+    static void setupAttributes() {
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(HalfVertex2D), (void*)offsetof(HalfVertex2D, pos));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(HalfVertex2D), (void*)offsetof(HalfVertex2D, color));
+    }
+};
+
+// No color attribute: Renderer2D draws these shapes with their shape color
+// through the override path (uniform per shape, or the shape data texels)
+template <>
+struct VertexLayout<PositionVertex2D> {
+    static constexpr bool perShapeColor = true;
+
+    static PositionVertex2D pack(const Vertex2D& v) { return { v.pos }; }
+    static Vertex2D unpack(const PositionVertex2D& p, const glm::vec3& shapeColor) { return { p.pos, shapeColor }; }
+
+    static void setupAttributes() {
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(PositionVertex2D), (void*)offsetof(PositionVertex2D, pos));
+        glDisableVertexAttribArray(1);
+    }
+};
+
+#if defined(SCED_VERTEX_FORMAT_FULL)
+using GpuVertex = Vertex2D;
+#elif defined(SCED_VERTEX_FORMAT_HALF)
+using GpuVertex = HalfVertex2D;
+#elif defined(SCED_VERTEX_FORMAT_POSITIONONLY)
+using GpuVertex = PositionVertex2D;
+#else
+using GpuVertex = PackedVertex2D;
+#endif
+
+using GpuVertexLayout = VertexLayout<GpuVertex>;
@@ -0,0 +1,53 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Turns variable frame times into whole fixed-size simulation steps, so game
+// logic behaves the same at any refresh rate. Leftover time carries over to
+// the next frame and alpha() tells the renderer how far it is between the
+// last two simulated states. A frame owing more than maxSteps updates drops
+// the surplus instead of falling further behind every frame.
+class FixedTimestep {
+public:
+    explicit FixedTimestep(double updateHz = 120.0, int maxSteps = 8) {
+        setUpdateRate(updateHz);
+        setMaxSteps(maxSteps);
+    }
+
+    void setUpdateRate(double hz) { dt = 1.0 / std::max(hz, 1.0); }
+    double updateRate() const { return 1.0 / dt; }
+    double step() const { return dt; }
+
+    void setMaxSteps(int steps) { maxSteps = std::max(steps, 1); }
+    int getMaxSteps() const { return maxSteps; }
+
+    // Add one frame's real time and get the number of updates to run now
+    int advance(double frameSeconds) {
+        accumulator += std::max(frameSeconds, 0.0);
+
+        const double owed = std::floor(accumulator / dt);
+        if (owed > maxSteps) {
+            dropped += (uint64_t)(owed - maxSteps);
+            accumulator = std::fmod(accumulator, dt) + maxSteps * dt;
+        }
+
+        const int steps = (int)std::min(owed, (double)maxSteps);
+        accumulator -= steps * dt;
+        return steps;
+    }
+
+    // 0 = draw the previous state, 1 = the current one
+    float alpha() const { return (float)std::clamp(accumulator / dt, 0.0, 1.0); }
+
+    // Steps skipped by the catch-up cap so far
+    uint64_t droppedSteps() const { return dropped; }
+
+    void reset() { accumulator = 0.0; }
+
+private:
+    double dt = 1.0 / 120.0;
+    double accumulator = 0.0;
+    int maxSteps = 8;
+    uint64_t dropped = 0;
+};
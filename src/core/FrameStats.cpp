@@ -0,0 +1,115 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+#include "../Renderer/RenderBackend.hpp"
+#include "../Renderer/Renderer2D.hpp"
+
+namespace {
+    uint64_t nowNs() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    double percentile(const std::vector<double>& sorted, double p) {
+        if (sorted.empty()) return 0.0;
+        const double rank = p * (double)(sorted.size() - 1);
+        const size_t lo = (size_t)rank;
+        const size_t hi = std::min(lo + 1, sorted.size() - 1);
+        return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - (double)lo);
+    }
+}
+
+void FrameStats::beginFrame() {
+    const RenderBackend::Counts c = RenderBackend::counts();
+    startDraws = c.drawCalls;
+    startVertices = c.vertices;
+    startBytes = c.bytesUploaded;
+    start = nowNs();
+}
+
+void FrameStats::endFrame(const RenderStats& rendered) {
+    const uint64_t end = nowNs();
+
+    Frame f;
+    f.milliseconds = (double)(end - start) / 1e6;
+
+    if (RenderBackend::active() == BackendKind::Null) {
+        const RenderBackend::Counts c = RenderBackend::counts();
+        f.drawCalls = (uint32_t)(c.drawCalls - startDraws);
+        f.vertices = c.vertices - startVertices;
+        f.bytesUploaded = c.bytesUploaded - startBytes;
+    } else {
+        f.drawCalls = rendered.drawCalls;
+        f.vertices = rendered.vertices;
+        f.bytesUploaded = rendered.bytesUploaded;
+    }
+    records.push_back(f);
+}
+
+FrameStats::Summary FrameStats::summary() const {
+    Summary s;
+    s.frames = (int)records.size();
+    if (records.empty()) return s;
+
+    std::vector<double> times;
+    times.reserve(records.size());
+    for (const Frame& f : records) {
+        times.push_back(f.milliseconds);
+        s.mean += f.milliseconds;
+        s.drawCalls += f.drawCalls;
+        s.vertices += (double)f.vertices;
+        s.bytesUploaded += (double)f.bytesUploaded;
+    }
+    std::sort(times.begin(), times.end());
+
+    const double n = (double)records.size();
+    s.p50 = percentile(times, 0.50);
+    s.p95 = percentile(times, 0.95);
+    s.p99 = percentile(times, 0.99);
+    s.max = times.back();
+    s.mean /= n;
+    s.drawCalls /= n;
+    s.vertices /= n;
+    s.bytesUploaded /= n;
+    return s;
+}
+
+void FrameStats::print(const char* label) const {
+    const Summary s = summary();
+    std::printf("%s: %d frames, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms (mean %.3f, max %.3f); "
+                "per frame %.1f draws, %.0f vertices, %.0f bytes uploaded\n",
+                label, s.frames, s.p50, s.p95, s.p99, s.mean, s.max, s.drawCalls, s.vertices, s.bytesUploaded);
+}
+
+bool FrameStats::writeJson(const std::string& path, const std::string& scenario, int sceneSize) const {
+    const Summary s = summary();
+
+    nlohmann::ordered_json doc;
+    doc["scenario"] = scenario;
+    doc["sceneSize"] = sceneSize;
+    doc["backend"] = RenderBackend::active() == BackendKind::Null ? "null" : "opengl";
+    doc["summary"] = {
+        {"frames", s.frames},
+        {"p50", s.p50},
+        {"p95", s.p95},
+        {"p99", s.p99},
+        {"mean", s.mean},
+        {"max", s.max},
+        {"drawCalls", s.drawCalls},
+        {"vertices", s.vertices},
+        {"bytesUploaded", s.bytesUploaded},
+    };
+
+    std::vector<double> times;
+    times.reserve(records.size());
+    for (const Frame& f : records) times.push_back(f.milliseconds);
+    doc["frameMs"] = times;
+
+    std::ofstream out(path);
+    out << doc.dump(2) << '\n';
+    return (bool)out;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct RenderStats;
+
+// Per-frame numbers for benchmark runs: wall time between beginFrame() and
+// endFrame(), plus the draw calls, vertices and upload bytes of the frame.
+// On the Null backend those are everything the backend received in between;
+// a real context reports nothing, so there they come from the renderer's
+// own RenderStats. Records every frame, so keep it to runs with a frame limit.
+class FrameStats {
+public:
+    struct Frame {
+        double milliseconds;
+        uint32_t drawCalls;
+        uint64_t vertices;
+        uint64_t bytesUploaded;
+    };
+
+    struct Summary {
+        int frames = 0;
+        double p50 = 0.0, p95 = 0.0, p99 = 0.0;   // frame time, ms
+        double mean = 0.0, max = 0.0;
+        double drawCalls = 0.0;                    // means per frame
+        double vertices = 0.0;
+        double bytesUploaded = 0.0;
+    };
+
+    void reserve(int frames) { records.reserve(frames); }
+    void beginFrame();
+    // rendered: the frame's Renderer2D::getStats(), used unless the Null backend is active
+    void endFrame(const RenderStats& rendered);
+
+    const std::vector<Frame>& getFrames() const { return records; }
+    Summary summary() const;
+
+    // One line: frames, percentiles and per-frame means
+    void print(const char* label) const;
+
+    // {"scenario", "sceneSize", "summary": {...}, "frameMs": [...]}
+    bool writeJson(const std::string& path, const std::string& scenario, int sceneSize) const;
+
+private:
+    std::vector<Frame> records;
+    uint64_t start = 0;
+    uint64_t startDraws = 0, startVertices = 0, startBytes = 0;
+};
@@ -0,0 +1,337 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <glad/glad.h>
+
+namespace {
+    constexpr uint64_t eventCapacity = 8192;      // per thread
+    constexpr uint64_t gpuEventCapacity = 4096;
+    constexpr uint64_t frameCapacity = 256;
+    constexpr int queryCapacity = 128;
+
+    struct Event {
+        const char* name;
+        uint64_t start;     // ns since the profiler started
+        uint64_t end;
+        uint32_t depth;
+    };
+
+    struct ThreadLog {
+        std::mutex mutex;   // only contended while a reader walks the ring
+        uint32_t id = 0;
+        std::string name;
+        std::unique_ptr<Event[]> events{new Event[eventCapacity]};
+        uint64_t written = 0;
+        int depth = 0;
+    };
+
+    struct State {
+        std::atomic<bool> enabled{false};
+        const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+        std::mutex mutex;   // threads, frames and the GPU log
+        std::vector<std::unique_ptr<ThreadLog>> threads;
+
+        uint64_t frames[frameCapacity] = {};
+        uint64_t frameCount = 0;
+
+        // Queries are used and retired in order, so the pool is a ring
+        GLuint queries[queryCapacity] = {};
+        const char* queryNames[queryCapacity] = {};
+        uint64_t queryStarts[queryCapacity] = {};
+        bool queryEnded[queryCapacity] = {};
+        int queryHead = 0;
+        int queryPending = 0;
+        bool queriesCreated = false;
+        bool gpuActive = false;
+
+        std::unique_ptr<Event[]> gpuEvents{new Event[gpuEventCapacity]};
+        uint64_t gpuWritten = 0;
+    };
+
+    State& state() {
+        static State s;
+        return s;
+    }
+
+    ThreadLog& threadLog() {
+        thread_local ThreadLog* log = nullptr;
+
+        // Once per thread; the log outlives the thread so its events can still be exported
+        if (!log) {
+            State& s = state();
+            std::lock_guard<std::mutex> lock(s.mutex);
+
+            s.threads.push_back(std::make_unique<ThreadLog>());
+            log = s.threads.back().get();
+            log->id = (uint32_t)s.threads.size();
+            log->name = "Thread " + std::to_string(log->id);
+        }
+
+        return *log;
+    }
+
+    // Walk the last capacity entries of a ring, oldest first
+    template <typename Fn>
+    void forEachEvent(const Event* events, uint64_t written, uint64_t capacity, Fn&& fn) {
+        const uint64_t first = written > capacity ? written - capacity : 0;
+        for (uint64_t i = first; i < written; ++i) fn(events[i % capacity]);
+    }
+
+    void addTotal(std::vector<Profiler::ScopeTotal>& out, const Event& e, bool gpu) {
+        for (auto& total : out) {
+            if (total.gpu == gpu && (total.name == e.name || std::strcmp(total.name, e.name) == 0)) {
+                total.milliseconds += (e.end - e.start) * 1e-6;
+                total.calls++;
+                return;
+            }
+        }
+
+        out.push_back({e.name, (e.end - e.start) * 1e-6, 1, gpu});
+    }
+
+    void writeJsonString(FILE* f, const char* s) {
+        std::fputc('"', f);
+        for (; *s; ++s) {
+            if (*s == '"' || *s == '\\') std::fputc('\\', f);
+            if ((unsigned char)*s >= 0x20) std::fputc(*s, f);
+        }
+        std::fputc('"', f);
+    }
+}
+
+namespace Profiler {
+    void setEnabled(bool enabled) {
+        state().enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool isEnabled() {
+        return state().enabled.load(std::memory_order_relaxed);
+    }
+
+    uint64_t now() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - state().epoch).count();
+    }
+
+    void setThreadName(const char* name) {
+        ThreadLog& log = threadLog();
+        std::lock_guard<std::mutex> lock(log.mutex);
+        log.name = name;
+    }
+
+    int enterScope() {
+        return threadLog().depth++;
+    }
+
+    void leaveScope(const char* name, uint64_t start, int depth) {
+        const uint64_t end = now();
+        ThreadLog& log = threadLog();
+
+        std::lock_guard<std::mutex> lock(log.mutex);
+        log.events[log.written % eventCapacity] = {name, start, end, (uint32_t)depth};
+        log.written++;
+        log.depth = depth;
+    }
+
+    void beginFrame() {
+        if (!isEnabled()) {
+            return;
+        }
+
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.frames[s.frameCount % frameCapacity] = now();
+        s.frameCount++;
+    }
+
+    int frameTimes(float* out, int maxFrames) {
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+
+        const uint64_t available = s.frameCount > frameCapacity ? frameCapacity : s.frameCount;
+        const int count = (int)std::min<uint64_t>(available > 0 ? available - 1 : 0, (uint64_t)maxFrames);
+
+        for (int i = 0; i < count; ++i) {
+            const uint64_t frame = s.frameCount - count - 1 + i;
+            out[i] = (float)((s.frames[(frame + 1) % frameCapacity] - s.frames[frame % frameCapacity]) * 1e-6);
+        }
+
+        return count;
+    }
+
+    void lastFrame(std::vector<ScopeTotal>& out) {
+        out.clear();
+
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+
+        if (s.frameCount < 2) {
+            return;
+        }
+
+        const uint64_t begin = s.frames[(s.frameCount - 2) % frameCapacity];
+        const uint64_t end = s.frames[(s.frameCount - 1) % frameCapacity];
+
+        for (auto& log : s.threads) {
+            std::lock_guard<std::mutex> logLock(log->mutex);
+
+            forEachEvent(log->events.get(), log->written, eventCapacity, [&](const Event& e) {
+                if (e.depth == 0 && e.start >= begin && e.start < end) addTotal(out, e, false);
+            });
+        }
+
+        // GPU results arrive a few frames late. Queries retire in order, so
+        // the frame before the one holding the newest result is complete.
+        uint64_t gpuBegin = 0, gpuEnd = 0;
+        if (s.gpuWritten > 0) {
+            const uint64_t latest = s.gpuEvents[(s.gpuWritten - 1) % gpuEventCapacity].start;
+
+            for (uint64_t f = s.frameCount; f-- > 1 && s.frameCount - f < frameCapacity;) {
+                if (s.frames[f % frameCapacity] <= latest) {
+                    gpuBegin = s.frames[(f - 1) % frameCapacity];
+                    gpuEnd = s.frames[f % frameCapacity];
+                    break;
+                }
+            }
+        }
+
+        forEachEvent(s.gpuEvents.get(), s.gpuWritten, gpuEventCapacity, [&](const Event& e) {
+            if (e.start >= gpuBegin && e.start < gpuEnd) addTotal(out, e, true);
+        });
+    }
+
+    int beginGpuScope(const char* name) {
+        State& s = state();
+
+        if (s.gpuActive || s.queryPending == queryCapacity) {
+            return -1;
+        }
+
+        if (!s.queriesCreated) {
+            glGenQueries(queryCapacity, s.queries);
+            s.queriesCreated = true;
+        }
+
+        const int query = s.queryHead;
+        s.queryHead = (s.queryHead + 1) % queryCapacity;
+        s.queryPending++;
+
+        s.queryNames[query] = name;
+        s.queryStarts[query] = now();
+        s.queryEnded[query] = false;
+        s.gpuActive = true;
+
+        glBeginQuery(GL_TIME_ELAPSED, s.queries[query]);
+        return query;
+    }
+
+    void endGpuScope(int query) {
+        State& s = state();
+
+        glEndQuery(GL_TIME_ELAPSED);
+        s.queryEnded[query] = true;
+        s.gpuActive = false;
+    }
+
+    void collectGpuTimings() {
+        State& s = state();
+
+        while (s.queryPending > 0) {
+            const int query = (s.queryHead - s.queryPending + queryCapacity) % queryCapacity;
+
+            if (!s.queryEnded[query]) {
+                break;
+            }
+
+            // Never wait: whatever is not finished is picked up next frame
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(s.queries[query], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                break;
+            }
+
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(s.queries[query], GL_QUERY_RESULT, &elapsed);
+            s.queryPending--;
+
+            // Placed at the CPU time the pass was issued
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.gpuEvents[s.gpuWritten % gpuEventCapacity] = {s.queryNames[query], s.queryStarts[query],
+                                                            s.queryStarts[query] + elapsed, 0};
+            s.gpuWritten++;
+        }
+    }
+
+    void releaseGpuResources() {
+        State& s = state();
+
+        if (s.queriesCreated) {
+            glDeleteQueries(queryCapacity, s.queries);
+            s.queriesCreated = false;
+        }
+
+        s.queryHead = 0;
+        s.queryPending = 0;
+        s.gpuActive = false;
+    }
+
+    bool writeChromeTrace(const std::string& path) {
+        FILE* f = std::fopen(path.c_str(), "w");
+        if (!f) {
+            return false;
+        }
+
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+
+        bool first = true;
+        auto separator = [&] {
+            std::fputs(first ? "\n" : ",\n", f);
+            first = false;
+        };
+
+        auto writeEvent = [&](const Event& e, uint32_t tid) {
+            separator();
+            std::fputs("{\"name\":", f);
+            writeJsonString(f, e.name);
+            std::fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         tid, e.start * 1e-3, (e.end - e.start) * 1e-3);
+        };
+
+        std::fputs("{\"traceEvents\":[", f);
+
+        for (auto& log : s.threads) {
+            std::lock_guard<std::mutex> logLock(log->mutex);
+
+            separator();
+            std::fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", log->id);
+            writeJsonString(f, log->name.c_str());
+            std::fputs("}}", f);
+
+            forEachEvent(log->events.get(), log->written, eventCapacity, [&](const Event& e) { writeEvent(e, log->id); });
+        }
+
+        // GPU passes on a track of their own
+        if (s.gpuWritten > 0) {
+            separator();
+            std::fputs("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU\"}}", f);
+            forEachEvent(s.gpuEvents.get(), s.gpuWritten, gpuEventCapacity, [&](const Event& e) { writeEvent(e, 0); });
+        }
+
+        const uint64_t firstFrame = s.frameCount > frameCapacity ? s.frameCount - frameCapacity : 0;
+        for (uint64_t i = firstFrame; i < s.frameCount; ++i) {
+            separator();
+            std::fprintf(f, "{\"name\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":%.3f}",
+                         s.frames[i % frameCapacity] * 1e-3);
+        }
+
+        std::fputs("\n]}\n", f);
+        return std::fclose(f) == 0;
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Frame profiler. CPU scopes nest per thread and land in a fixed ring per
+// thread; GPU scopes wrap GL_TIME_ELAPSED queries from a fixed pool and are
+// read back a few frames later without stalling. Nothing allocates per frame
+// once a thread has logged its first scope.
+//
+// Off until setEnabled(true), and compiled out entirely without
+// SCED_PROFILING. GPU scopes cannot nest (GL allows one active time query);
+// an inner one is skipped.
+namespace Profiler {
+    struct ScopeTotal {
+        const char* name;
+        double milliseconds;
+        uint32_t calls;
+        bool gpu;
+    };
+
+    void setEnabled(bool enabled);
+    bool isEnabled();
+
+    // Mark the start of a frame, once per frame from the app loop that drives
+    // it; per-renderer calls would split a frame when several renderers exist
+    void beginFrame();
+    // Frame durations in ms, oldest first; returns how many were written
+    int frameTimes(float* out, int maxFrames);
+
+    // Totals per top-level scope name over the last complete frame, CPU scopes
+    // of every thread and GPU scopes whose results have arrived; out is reused
+    void lastFrame(std::vector<ScopeTotal>& out);
+
+    // Fetch finished GPU timings; once per frame on the GL thread
+    void collectGpuTimings();
+    // Delete the query pool; call while its context is still current
+    void releaseGpuResources();
+
+    // Everything still in the rings, as Chrome trace JSON (chrome://tracing, Perfetto)
+    bool writeChromeTrace(const std::string& path);
+
+    void setThreadName(const char* name);
+
+    // Implementation for the scope objects below
+    uint64_t now();
+    int enterScope();
+    void leaveScope(const char* name, uint64_t start, int depth);
+    int beginGpuScope(const char* name);
+    void endGpuScope(int query);
+}
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : name(name) {
+        if (Profiler::isEnabled()) {
+            depth = Profiler::enterScope();
+            start = Profiler::now();
+        }
+    }
+
+    ~ProfileScope() {
+        if (depth >= 0) Profiler::leaveScope(name, start, depth);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t start = 0;
+    int depth = -1;
+};
+
+class GpuProfileScope {
+public:
+    explicit GpuProfileScope(const char* name)
+        : query(Profiler::isEnabled() ? Profiler::beginGpuScope(name) : -1) {}
+
+    ~GpuProfileScope() {
+        if (query >= 0) Profiler::endGpuScope(query);
+    }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    int query;
+};
+
+#define SCED_PROFILE_CONCAT_(a, b) a##b
+#define SCED_PROFILE_CONCAT(a, b) SCED_PROFILE_CONCAT_(a, b)
+
+#ifdef SCED_PROFILING
+// name must outlive the profiler (a string literal)
+#define SCED_PROFILE_SCOPE(name) ProfileScope SCED_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define SCED_PROFILE_GPU(name) GpuProfileScope SCED_PROFILE_CONCAT(gpuProfileScope_, __LINE__)(name)
+#else
+#define SCED_PROFILE_SCOPE(name) ((void)0)
+#define SCED_PROFILE_GPU(name) ((void)0)
+#endif
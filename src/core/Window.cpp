@@ -4,29 +4,82 @@
 
 #include "Window.h"
 #include <stdexcept>
+#include <cstdlib>
+#include <cstring>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
-Window::Window(int width, int height, std::string title) : m_NativeWindow(nullptr)
+WindowMode Window::modeFromEnvironment()
 {
+    const char* value = std::getenv("SCED_HEADLESS");
 
+    if (!value || !*value || std::strcmp(value, "0") == 0) {
+        return WindowMode::Windowed;
+    }
+
+    return std::strcmp(value, "null") == 0 ? WindowMode::Null : WindowMode::Headless;
+}
+
+bool Window::initGlfw(WindowMode mode)
+{
+    if (mode != WindowMode::Windowed) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+
+    return glfwInit() == GLFW_TRUE;
+}
+
+GLFWwindow* Window::createNative(int width, int height, const char* title, WindowMode mode)
+{
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_API);
+
+    if (mode == WindowMode::Windowed) {
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_NATIVE_CONTEXT_API);
+        return glfwCreateWindow(width, height, title, NULL, NULL);
+    }
+
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 
-    this->m_NativeWindow = glfwCreateWindow(width,
-        height,
-        title.c_str(),
-        NULL,
-        NULL);
+    if (mode == WindowMode::Null) {
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+        return glfwCreateWindow(width, height, title, NULL, NULL);
+    }
+
+    // EGL first (surfaceless on Mesa), OSMesa as the software fallback
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+    GLFWwindow* window = glfwCreateWindow(width, height, title, NULL, NULL);
+
+    if (!window) {
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        window = glfwCreateWindow(width, height, title, NULL, NULL);
+    }
+
+    return window;
+}
+
+Window::Window(int width, int height, std::string title, WindowMode mode) : m_NativeWindow(nullptr)
+{
+    this->m_NativeWindow = createNative(width, height, title.c_str(), mode);
 
     if (!this->m_NativeWindow)
     {
         throw std::runtime_error("Failed to create GLFW window");
     }
 
-    glfwMakeContextCurrent(this->m_NativeWindow);
-    glfwSwapInterval(1); // For v-sync
+    if (mode != WindowMode::Null) {
+        glfwMakeContextCurrent(this->m_NativeWindow);
+        glfwSwapInterval(1); // For v-sync
+    }
+}
+
+void Window::swapBuffers(GLFWwindow* window)
+{
+    if (glfwGetWindowAttrib(window, GLFW_CLIENT_API) != GLFW_NO_API) {
+        glfwSwapBuffers(window);
+    }
 }
 
 Window::~Window()
@@ -6,13 +6,33 @@
 
 struct GLFWwindow;
 
+// Headless: GLFW's null platform with an EGL (or OSMesa) context and no
+// window system, for machines without a display or GPU (Mesa llvmpipe).
+// Draw into an OffscreenTarget and read the pixels back.
+// Null: same null platform with no context at all, for the Null render
+// backend (see RenderBackend.hpp).
+enum class WindowMode {
+    Windowed,
+    Headless,
+    Null
+};
+
 class Window
 {
 private:
     GLFWwindow* m_NativeWindow;
 
 public:
-    Window(int width, int height, std::string title);
+    Window(int width, int height, std::string title, WindowMode mode = WindowMode::Windowed);
+
+    // SCED_HEADLESS=null picks Null, anything else but 0 picks Headless
+    static WindowMode modeFromEnvironment();
+    // glfwInit() for the given mode; the platform is fixed at init time
+    static bool initGlfw(WindowMode mode);
+    // Context hints + glfwCreateWindow, for mains that manage the window themselves
+    static GLFWwindow* createNative(int width, int height, const char* title, WindowMode mode);
+    // glfwSwapBuffers, skipped for windows without a context
+    static void swapBuffers(GLFWwindow* window);
     ~Window();
 
     Window(const Window&) = delete;
@@ -21,4 +41,4 @@ public:
     bool shouldClose() const;
 
     GLFWwindow* getNativeWindow() const { return m_NativeWindow; }
-};
\ No newline at end of file
+};
\ No newline at end of file
@@ -8,17 +8,54 @@
 Input::Input() : mouseX(0.0), mouseY(0.0) {
 	memset(keys, false, sizeof(keys));
 	memset(lastKeys, false, sizeof(lastKeys));
+	memset(buttons, false, sizeof(buttons));
 }
 
 void Input::initialize(GLFWwindow* window) {
 	glfwSetWindowUserPointer(window, this);
 
 	glfwSetKeyCallback(window, key_callback);
+	glfwSetMouseButtonCallback(window, mouse_button_callback);
 	glfwSetCursorPosCallback(window, cursor_position_callback);
 }
 
 void Input::endFrame() {
 	memcpy(lastKeys, keys, sizeof(keys));
+
+	if (scripted) {
+		++scriptFrame;
+		applyScript();
+	}
+}
+
+void Input::play(const InputScript& s, double rate) {
+	script = s;
+	scripted = true;
+	scriptFrame = 0;
+	scriptEvent = 0;
+	scriptRate = rate > 0.0 ? rate : 60.0;
+	applyScript();
+}
+
+void Input::applyScript() {
+	const auto& events = script.getEvents();
+
+	while (scriptEvent < events.size() && events[scriptEvent].frame <= scriptFrame) {
+		const InputScript::Event& e = events[scriptEvent++];
+
+		switch (e.kind) {
+			case InputScript::Kind::Key:
+				if (e.code >= 0 && e.code < MAX_KEYS) keys[e.code] = e.down;
+				break;
+			case InputScript::Kind::Button:
+				if (e.code >= 0 && e.code < MAX_BUTTONS) buttons[e.code] = e.down;
+				break;
+			case InputScript::Kind::Move:
+				mouseX = e.x;
+				mouseY = e.y;
+				break;
+		}
+	}
 }
 
 bool Input::isKeyPressed(int key) const {
@@ -42,6 +79,13 @@ bool Input::isKeyUp(int key) const {
 	return false;
 }
 
+bool Input::isMouseButtonPressed(int button) const {
+	if (button >= 0 && button < MAX_BUTTONS) {
+		return buttons[button];
+	}
+	return false;
+}
+
 double Input::getMouseX() const {
 	return mouseX;
 }
@@ -52,7 +96,7 @@ double Input::getMouseY() const {
 
 void Input::key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     Input* inputManager = static_cast<Input*>(glfwGetWindowUserPointer(window));
-    if (inputManager && key >= 0 && key < MAX_KEYS) {
+    if (inputManager && !inputManager->scripted && key >= 0 && key < MAX_KEYS) {
         if (action == GLFW_PRESS) {
             inputManager->keys[key] = true;
         } else if (action == GLFW_RELEASE) {
@@ -61,10 +105,21 @@ void Input::key_callback(GLFWwindow* window, int key, int scancode, int action,
     }
 }
 
+void Input::mouse_button_callback(GLFWwindow* window, int button, int action, int /*mods*/) {
+	Input* inputManager = static_cast<Input*>(glfwGetWindowUserPointer(window));
+	if (inputManager && !inputManager->scripted && button >= 0 && button < MAX_BUTTONS) {
+		if (action == GLFW_PRESS) {
+			inputManager->buttons[button] = true;
+		} else if (action == GLFW_RELEASE) {
+			inputManager->buttons[button] = false;
+		}
+	}
+}
+
 void Input::cursor_position_callback(GLFWwindow* window, double xpos, double ypos) {
 	Input* inputManager = static_cast<Input*>(glfwGetWindowUserPointer(window));
 
-	if (inputManager) {
+	if (inputManager && !inputManager->scripted) {
 		inputManager->mouseX = xpos;
 		inputManager->mouseY = ypos;
 
@@ -1,4 +1,5 @@
 #pragma once
+#include "InputScript.h"
 
 struct GLFWwindow;
 
@@ -12,15 +13,37 @@ class Input {
 		bool isKeyDown(int key) const;
 		bool isKeyUp(int key) const;
 
+		bool isMouseButtonPressed(int button) const;
+
 		double getMouseX() const;
 		double getMouseY() const;
+
+		// Replay a script instead of the window's events: frame 0 applies
+		// now and each endFrame() applies the next frame. Scripted runs see
+		// time advance by 1 / rate per frame (scriptTime), whatever the
+		// frames really took, so they replay the same way every run.
+		void play(const InputScript& script, double rate = 60.0);
+		bool isScripted() const { return scripted; }
+		int getScriptFrame() const { return scriptFrame; }
+		double scriptTime() const { return scriptFrame / scriptRate; }
 	private:
 	    static constexpr int MAX_KEYS = 512;
+	    static constexpr int MAX_BUTTONS = 8;
 		bool keys[MAX_KEYS];
 		bool lastKeys[MAX_KEYS];
+		bool buttons[MAX_BUTTONS];
 		double mouseX;
 		double mouseY;
 
+		InputScript script;
+		bool scripted = false;
+		int scriptFrame = 0;
+		size_t scriptEvent = 0;
+		double scriptRate = 60.0;
+
+		void applyScript();
+
 		static void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+		static void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
 		static void cursor_position_callback(GLFWwindow* window, double xpos, double ypos);
 };
@@ -0,0 +1,144 @@
+#include "InputScript.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <GLFW/glfw3.h>
+
+namespace {
+	struct NamedKey {
+		const char* name;
+		int code;
+	};
+
+	const NamedKey namedKeys[] = {
+		{ "UP",     GLFW_KEY_UP },
+		{ "DOWN",   GLFW_KEY_DOWN },
+		{ "LEFT",   GLFW_KEY_LEFT },
+		{ "RIGHT",  GLFW_KEY_RIGHT },
+		{ "SPACE",  GLFW_KEY_SPACE },
+		{ "ENTER",  GLFW_KEY_ENTER },
+		{ "ESCAPE", GLFW_KEY_ESCAPE },
+	};
+
+	const char* keyName(int code) {
+		for (const NamedKey& k : namedKeys) {
+			if (k.code == code) return k.name;
+		}
+		return nullptr;
+	}
+}
+
+void InputScript::key(int frame, int key, bool down) {
+	insert(Event{ frame, Kind::Key, key, down, 0.0, 0.0 });
+}
+
+void InputScript::button(int frame, int button, bool down) {
+	insert(Event{ frame, Kind::Button, button, down, 0.0, 0.0 });
+}
+
+void InputScript::move(int frame, double x, double y) {
+	insert(Event{ frame, Kind::Move, 0, false, x, y });
+}
+
+void InputScript::insert(const Event& e) {
+	// After every event of the same frame, so a frame replays in order
+	auto at = std::upper_bound(events.begin(), events.end(), e.frame,
+		[](int frame, const Event& other) { return frame < other.frame; });
+	events.insert(at, e);
+}
+
+int InputScript::lastFrame() const {
+	return events.empty() ? 0 : events.back().frame;
+}
+
+int InputScript::keyCode(const std::string& name) {
+	// GLFW's printable key codes are their upper case ASCII
+	if (name.size() == 1) {
+		const char c = name[0];
+		if (c >= 'a' && c <= 'z') return c - 'a' + 'A';
+		if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) return c;
+	}
+
+	for (const NamedKey& k : namedKeys) {
+		if (name == k.name) return k.code;
+	}
+
+	char* end = nullptr;
+	const long code = std::strtol(name.c_str(), &end, 10);
+	return (end && *end == '\0' && !name.empty()) ? (int)code : -1;
+}
+
+bool InputScript::load(const std::string& path) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		std::cerr << "InputScript: cannot open " << path << "\n";
+		return false;
+	}
+
+	events.clear();
+
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line)) {
+		++lineNumber;
+		line = line.substr(0, line.find('#'));
+
+		std::istringstream in(line);
+		int frame = 0;
+		std::string kind;
+		if (!(in >> frame >> kind)) continue;   // blank or comment
+
+		bool ok = false;
+		if (kind == "move") {
+			double x = 0.0, y = 0.0;
+			ok = (bool)(in >> x >> y);
+			if (ok) move(frame, x, y);
+		} else if (kind == "key" || kind == "button") {
+			std::string name, state;
+			ok = (bool)(in >> name >> state) && (state == "down" || state == "up");
+			const int code = kind == "key" ? keyCode(name) : std::atoi(name.c_str());
+			ok = ok && code >= 0;
+			if (ok && kind == "key") key(frame, code, state == "down");
+			if (ok && kind == "button") button(frame, code, state == "down");
+		}
+
+		if (!ok) {
+			std::cerr << "InputScript: " << path << ":" << lineNumber << ": cannot read \"" << line << "\"\n";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool InputScript::save(const std::string& path) const {
+	std::ofstream file(path);
+	if (!file.is_open()) return false;
+
+	file << "# frame event args\n";
+	for (const Event& e : events) {
+		file << e.frame << " ";
+		switch (e.kind) {
+			case Kind::Move:
+				file << "move " << e.x << " " << e.y << "\n";
+				break;
+			case Kind::Button:
+				file << "button " << e.code << (e.down ? " down\n" : " up\n");
+				break;
+			case Kind::Key: {
+				const char* name = keyName(e.code);
+				file << "key ";
+				if (name) file << name;
+				else if ((e.code >= 'A' && e.code <= 'Z') || (e.code >= '0' && e.code <= '9')) file << (char)e.code;
+				else file << e.code;
+				file << (e.down ? " down\n" : " up\n");
+				break;
+			}
+		}
+	}
+
+	return (bool)file;
+}
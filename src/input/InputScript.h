@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Recorded input for replaying an app without a user: key and mouse button
+// presses/releases and cursor moves, each tagged with the frame it happens
+// on. Input::play() applies them as if GLFW had delivered them.
+//
+// Text form, one event per line, '#' starts a comment:
+//
+//   <frame> key    <A-Z, 0-9, UP, DOWN, LEFT, RIGHT, SPACE, ENTER, ESCAPE or code> down|up
+//   <frame> button <0 left, 1 right, 2 middle> down|up
+//   <frame> move   <x> <y>          (window pixels, origin top left)
+class InputScript {
+public:
+	enum class Kind {
+		Key,
+		Button,
+		Move
+	};
+
+	struct Event {
+		int frame;
+		Kind kind;
+		int code;        // key or button
+		bool down;
+		double x, y;     // Move
+	};
+
+	void key(int frame, int key, bool down);
+	void button(int frame, int button, bool down);
+	void move(int frame, double x, double y);
+
+	// Events in frame order; equal frames keep the order they were added in
+	const std::vector<Event>& getEvents() const { return events; }
+	int lastFrame() const;
+	bool empty() const { return events.empty(); }
+
+	bool load(const std::string& path);
+	bool save(const std::string& path) const;
+
+	static int keyCode(const std::string& name);
+
+private:
+	std::vector<Event> events;
+
+	void insert(const Event& e);
+};
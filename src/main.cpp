@@ -1,10 +1,32 @@
 #include "Application/Application.h"
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "Create app" << std::endl;
     Application app(800, 600, "SCEd 2D Uniform Renderer");
 
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--render-thread") == 0) {
+            app.setRenderThread(true);
+        } else if (std::strcmp(argv[i], "--profile") == 0) {
+            app.setProfiling(true);
+        } else if (std::strcmp(argv[i], "--headless") == 0) {
+            app.setHeadless(true);
+        } else if (std::strcmp(argv[i], "--null") == 0) {
+            app.setWindowMode(WindowMode::Null);
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            app.setFrameLimit(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--screenshot") == 0 && i + 1 < argc) {
+            app.setScreenshotPath(argv[++i]);
+        } else if (std::strcmp(argv[i], "--update-hz") == 0 && i + 1 < argc) {
+            app.setUpdateRate(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--render-hz") == 0 && i + 1 < argc) {
+            app.setRenderRate(std::atof(argv[++i]));
+        }
+    }
+
     std::cout << "Running app" << std::endl;
     app.run();
 
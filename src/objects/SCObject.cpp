@@ -1,4 +1,6 @@
 #include "SCObject.hpp"
+#include "../core/Profiler.h"
+#include <algorithm>
 
 SCObject::SCObject(Renderer2D* r)
     : renderer(r)
@@ -11,39 +13,100 @@ SCObject::SCObject(Renderer2D* r)
 // -------------------------------
 ShapeHandle SCObject::addShape(const std::vector<Vertex2D>& vertices) {
     ShapeHandle handle = renderer->addShape(vertices.data(), (int)vertices.size(), model);
-    shapes[handle.id] = handle;
-    localModels[handle.id] = glm::mat4(1.f);
-    return handle;
+    return track(handle, glm::mat4(1.f));
+}
+
+ShapeHandle SCObject::addShape(const Mesh2D& mesh) {
+    ShapeHandle handle = renderer->addShape(mesh, model);
+    return track(handle, glm::mat4(1.f));
 }
 
 ShapeHandle SCObject::addShape(const IShape2D& shape) {
-    return addShape(shape.generateVertices());
+    SdfPrimitive prim;
+    glm::vec2 origin;
+    glm::vec3 color;
+
+    if (shape.sdfPrimitive(prim, origin, color)) {
+        glm::mat4 local = Transform::translate(glm::mat4(1.f), origin);
+        return track(renderer->addPrimitive(prim, model * local, color), local);
+    }
+
+    return addShape(shape.generateMesh());
+}
+
+ShapeHandle SCObject::addInstance(const IShape2D& shape) {
+    MeshKey key;
+    glm::vec2 origin;
+    glm::vec3 color;
+
+    if (shape.isAnalytic() || !shape.instanceKey(key, origin, color)) {
+        return addShape(shape);
+    }
+
+    glm::mat4 local = Transform::translate(glm::mat4(1.f), origin);
+    return track(renderer->addInstance(renderer->getCachedMesh(key), model * local, color), local);
+}
+
+ShapeHandle SCObject::track(ShapeHandle handle, const glm::mat4& local) {
+    shapes[handle.key()] = handle;
+    localModels[handle.key()] = local;
+    boundsDirty = true;
+
+    if (layer != 0)
+        renderer->setLayer(handle, layer);
+
+    return handle;
 }
 
 // -------------------------------
 // Setting Local Shape Transform
 // -------------------------------
 void SCObject::setShapeModel(ShapeHandle handle, const glm::mat4& local) {
-    if (shapes.find(handle.id) == shapes.end()) return;
-    localModels[handle.id] = local;
+    if (shapes.find(handle.key()) == shapes.end()) return;
+    localModels[handle.key()] = local;
     renderer->setModel(handle, model * local);
+    boundsDirty = true;
 }
 
 // -------------------------------
 // Global Transform System
 // -------------------------------
-glm::mat4 SCObject::buildModel() const {
+glm::mat4 SCObject::composeModel(glm::vec2 pos, float rot, glm::vec2 scale) {
     glm::mat4 m(1.f);
-    m = Transform::translate(m, globalPos);
-    m = Transform::rotateZ(m, globalRot);
-    m = Transform::scale(m, globalScale);
+    m = Transform::translate(m, pos);
+    m = Transform::rotateZ(m, rot);
+    m = Transform::scale(m, scale);
     return m;
 }
 
+glm::mat4 SCObject::buildModel() const {
+    return composeModel(globalPos, globalRot, globalScale);
+}
+
 void SCObject::updateAllModels() {
+    SCED_PROFILE_SCOPE("SCObject::updateAllModels");
+
     model = buildModel();
+    applyModel(model);
+}
+
+void SCObject::applyModel(const glm::mat4& m) {
     for (auto& [id, handle] : shapes)
-        renderer->setModel(handle, model * localModels[id]);
+        renderer->setModel(handle, m * localModels[id]);
+    boundsDirty = true;
+}
+
+void SCObject::saveState() {
+    previousPos = globalPos;
+    previousRot = globalRot;
+    previousScale = globalScale;
+}
+
+void SCObject::interpolate(float alpha) {
+    // Components blend separately so rotation stays a rotation
+    applyModel(composeModel(glm::mix(previousPos, globalPos, alpha),
+                            glm::mix(previousRot, globalRot, alpha),
+                            glm::mix(previousScale, globalScale, alpha)));
 }
 
 void SCObject::setPosition(const glm::vec2 position) {
@@ -61,6 +124,59 @@ void SCObject::setScale(const glm::vec2 scale) {
     updateAllModels();
 }
 
+bool SCObject::removeShape(ShapeHandle handle) {
+    if (shapes.erase(handle.key()) == 0)
+        return false;
+
+    localModels.erase(handle.key());
+    renderer->removeShape(handle);
+    boundsDirty = true;
+    return true;
+}
+
+void SCObject::clear() {
+    for (auto& [id, handle] : shapes)
+        renderer->removeShape(handle);
+
+    shapes.clear();
+    localModels.clear();
+    boundsDirty = true;
+}
+
+// -------------------------------
+// Draw Order
+// -------------------------------
+void SCObject::setLayer(int l) {
+    layer = l;
+    for (auto& [id, handle] : shapes)
+        renderer->setLayer(handle, layer);
+}
+
+namespace {
+    // Live handles ordered back to front by their current depth
+    std::vector<ShapeHandle> byDepth(const Renderer2D* renderer, std::vector<ShapeHandle> handles) {
+        handles.erase(std::remove_if(handles.begin(), handles.end(),
+                                     [&](ShapeHandle h) { return !renderer->isValid(h); }),
+                      handles.end());
+
+        std::sort(handles.begin(), handles.end(), [&](ShapeHandle a, ShapeHandle b) {
+            return renderer->getRecord(a)->depth < renderer->getRecord(b)->depth;
+        });
+        return handles;
+    }
+}
+
+void SCObject::bringToFront() {
+    for (auto& handle : byDepth(renderer, getShapeHandles()))
+        renderer->bringToFront(handle);
+}
+
+void SCObject::sendToBack() {
+    auto handles = byDepth(renderer, getShapeHandles());
+    for (auto it = handles.rbegin(); it != handles.rend(); ++it)
+        renderer->sendToBack(*it);
+}
+
 // -------------------------------
 // Visibility
 // -------------------------------
@@ -72,11 +188,30 @@ bool SCObject::isVisible() const {
     return visible;
 }
 
+// -------------------------------
+// Bounds
+// -------------------------------
+Aabb2D SCObject::bounds() const {
+    if (boundsDirty) {
+        cachedBounds = Aabb2D{};
+        renderer->flushBounds();
+
+        for (auto& [id, handle] : shapes) {
+            if (const ShapeRecord* r = renderer->getRecord(handle))
+                cachedBounds.expand(r->bounds);
+        }
+
+        boundsDirty = false;
+    }
+
+    return cachedBounds;
+}
+
 // -------------------------------
 // Color
 // -------------------------------
 void SCObject::setShapeColor(ShapeHandle handle, const glm::vec3& color) {
-    auto it = shapes.find(handle.id);
+    auto it = shapes.find(handle.key());
     if (it != shapes.end())
         renderer->setOverrideColor(handle, color);
 }
@@ -93,7 +228,8 @@ void SCObject::draw(const Shader& shader, const glm::mat4& vp) const{
     for (auto& [id, handle] : shapes)
         list.push_back(handle);
 
-    renderer->drawShape(shader, vp, list);
+    Aabb2D box = bounds();
+    renderer->drawShape(shader, vp, list, &box);
 }
 
 // -------------------------------
@@ -106,31 +242,26 @@ SCObject SCObject::clone() const {
     copy.globalPos = globalPos;
     copy.globalRot = globalRot;
     copy.globalScale = globalScale;
+    copy.previousPos = previousPos;
+    copy.previousRot = previousRot;
+    copy.previousScale = previousScale;
 
     copy.model = model;
+    copy.layer = layer;
 
     // clone each shape
     for (auto& [id, handle] : shapes)
     {
-        const ShapeRecord* record = renderer->getRecord(handle);
-        if (!record) continue;
-
-        const auto& cpuBuf = renderer->getCPUBuffer();
+        auto it = localModels.find(id);
+        glm::mat4 local = it != localModels.end() ? it->second : glm::mat4(1.f);
 
-        std::vector<Vertex2D> verts(
-            cpuBuf.begin() + record->offset,
-            cpuBuf.begin() + record->offset + record->count
-        );
+        ShapeHandle newHandle = renderer->cloneShape(handle, model * local);
+        if (!newHandle.valid()) continue;
 
-        ShapeHandle newHandle = renderer->addShape(verts.data(), (int)verts.size(), model);
-        copy.shapes[newHandle.id] = newHandle;
+        copy.shapes[newHandle.key()] = newHandle;
 
         // copy per-shape local model
-        auto it = localModels.find(id);
-        if (it != localModels.end())
-            copy.localModels[newHandle.id] = it->second;
-        else
-            copy.localModels[newHandle.id] = glm::mat4(1.f);
+        copy.localModels[newHandle.key()] = local;
     }
 
     return copy;
@@ -16,23 +16,42 @@ private:
     float      globalRot    = 0.f;
     glm::vec2  globalScale  = {1.f, 1.f};
 
+    // Components as of the last saveState(), for interpolate()
+    glm::vec2  previousPos   = {0.f, 0.f};
+    float      previousRot   = 0.f;
+    glm::vec2  previousScale = {1.f, 1.f};
+
     glm::mat4 model = glm::mat4(1.f);
 
-    std::unordered_map<int, ShapeHandle> shapes;
-    std::unordered_map<int, glm::mat4> localModels; // per-shape offsets
+    std::unordered_map<uint64_t, ShapeHandle> shapes;
+    std::unordered_map<uint64_t, glm::mat4> localModels; // per-shape offsets, keyed by ShapeHandle::key()
 
     bool visible = true;
+    int layer = 0;
+
+    // Union of the shapes' world bounds, recomputed on demand after changes
+    mutable Aabb2D cachedBounds;
+    mutable bool boundsDirty = true;
 
     // rebuild model and push to renderer
     void updateAllModels();
+    void applyModel(const glm::mat4& m);
 
     glm::mat4 buildModel() const;
+    static glm::mat4 composeModel(glm::vec2 pos, float rot, glm::vec2 scale);
+
+    ShapeHandle track(ShapeHandle handle, const glm::mat4& local);
 
 public:
     SCObject(Renderer2D* renderer);
 
     ShapeHandle addShape(const std::vector<Vertex2D>& vertices);
+    ShapeHandle addShape(const Mesh2D& mesh);
     ShapeHandle addShape(const IShape2D& shape);
+    // Parametric shapes reference one cached mesh per (type, size, segments);
+    // the shape's position becomes its local model. Analytic shapes and shapes
+    // without a key go through addShape().
+    ShapeHandle addInstance(const IShape2D& shape);
 
     void setShapeModel(ShapeHandle handle, const glm::mat4& local);
     void setShapeColor(ShapeHandle handle, const glm::vec3& color);
@@ -42,11 +61,36 @@ public:
     void setRotation(float radians);
     void setScale(const glm::vec2 scale);
 
+    glm::vec2 getPosition() const { return globalPos; }
+
+    // Fixed-timestep rendering: saveState() at the start of each update step,
+    // then interpolate() before drawing shows the object between the last two
+    // states without changing them. Call saveState() again after a teleport
+    // so it is not drawn sliding there.
+    void saveState();
+    void interpolate(float alpha);
+
+    // Draw order: every shape of the object moves to the layer, and
+    // front/back keep the shapes' order among themselves
+    void setLayer(int layer);
+    int getLayer() const { return layer; }
+    void bringToFront();
+    void sendToBack();
+
+    // Remove one shape, or every shape, from the renderer
+    bool removeShape(ShapeHandle handle);
+    void clear();
+
     void setVisible(bool v);
     bool isVisible() const;
 
+    // World-space box around every shape; draw() skips the object when it is
+    // outside the view
+    Aabb2D bounds() const;
+
     void draw(const Shader& shader, const glm::mat4& vp) const;
 
+    // Clones reference the same geometry instead of copying vertices
     SCObject clone() const;
 
     std::vector<ShapeHandle> getShapeHandles() const {
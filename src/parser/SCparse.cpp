@@ -119,35 +119,44 @@ std::unique_ptr<IShape2D> SCParse::createShape(const std::string& name)
     glm::vec2 pos   = readVec2(node, "position");
     glm::vec3 color = readColorRgb(node, "color");
 
+    std::unique_ptr<IShape2D> shape;
+
     // ---- circle ----
     if (type == "circle") {
         float radius   = node.value("radius",   0.1f);
         int   segments = node.value("segments", 32);
-        return std::make_unique<CircleShape>(pos, radius, segments, color);
+        shape = std::make_unique<CircleShape>(pos, radius, segments, color);
     }
 
     // ---- rectangle ----
-    if (type == "rectangle") {
+    else if (type == "rectangle") {
         glm::vec2 size = readVec2(node, "size", glm::vec2(0.5f, 0.25f));
         RectangleShape rect = SCArch::Rect(size.x, size.y, pos, color);
-        return std::make_unique<RectangleShape>(rect);
+        rect.setCornerRadius(node.value("corner_radius", 0.0f));
+        shape = std::make_unique<RectangleShape>(rect);
     }
 
     // ---- ellipse ----
-    if (type == "ellipse") {
+    else if (type == "ellipse") {
         glm::vec2 radii = readVec2(node, "radii", glm::vec2(0.5f, 0.25f));
         int segments    = node.value("segments", 64);
         // EllipseShape(glm::vec2 center, glm::vec2 radii, int segments, glm::vec3 color)
-        return std::make_unique<EllipseShape>(pos, radii, segments, color);
+        shape = std::make_unique<EllipseShape>(pos, radii, segments, color);
     }
 
     // ---- regular polygon ----
-    if (type == "regular_polygon") {
+    else if (type == "regular_polygon") {
         float radius = node.value("radius", 0.5f);
         int   sides  = node.value("sides",  6);
         // RegularPolygonShape(glm::vec2 center, float radius, int sides, glm::vec3 color)
-        return std::make_unique<RegularPolygonShape>(pos, radius, sides, color);
+        shape = std::make_unique<RegularPolygonShape>(pos, radius, sides, color);
+    }
+
+    else {
+        throw std::runtime_error("SCParse::getShape - unsupported shape type \"" + type + "\"");
     }
 
-    throw std::runtime_error("SCParse::getShape - unsupported shape type \"" + type + "\"");
+    // "analytic": true draws circles, ellipses and rectangles as one antialiased quad
+    shape->setAnalytic(node.value("analytic", false));
+    return shape;
 }
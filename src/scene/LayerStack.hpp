@@ -1,6 +1,8 @@
 #pragma once
+#include <memory>
 #include <vector>
 #include "../objects/SCObject.hpp"
+#include "../Renderer/Canvas.hpp"
 
 class LayerStack {
 public:
@@ -15,7 +17,10 @@ public:
     }
 
     void next() {
-        if (currentIndex == layers.size() - 1) layers.emplace_back(renderer);
+        if (currentIndex == layers.size() - 1) {
+            layers.emplace_back(renderer);
+            if (canvasEnabled) addCanvas();
+        }
         ++currentIndex;
     }
 
@@ -26,9 +31,76 @@ public:
 
     const std::vector<SCObject>& all() const { return layers; }
 
+    // Canvas mode: every frame gets a texture covering [worldMin, worldMax]
+    // and commit() bakes the live strokes into it, so drawing a frame costs
+    // one quad plus whatever stroke is still in progress. Strokes reaching
+    // past the canvas (the view can be wider) stay live shapes instead of
+    // being clipped.
+    void enableCanvas(int width, int height, glm::vec2 worldMin, glm::vec2 worldMax) {
+        canvasEnabled = true;
+        canvasWidth = width;
+        canvasHeight = height;
+        canvasMin = worldMin;
+        canvasMax = worldMax;
+
+        while (canvases.size() < layers.size()) addCanvas();
+    }
+
+    bool canvasOn() const { return canvasEnabled; }
+
+    void commit(const Shader& shader) {
+        if (!canvasEnabled) return;
+
+        SCObject& layer = layers[currentIndex];
+        const Aabb2D canvasBox{ canvasMin, canvasMax };
+        renderer->flushBounds();
+
+        std::vector<ShapeHandle> inside;
+        for (ShapeHandle h : layer.getShapeHandles()) {
+            const ShapeRecord* r = renderer->getRecord(h);
+            if (r && canvasBox.contains(r->bounds)) inside.push_back(h);
+        }
+
+        canvases[currentIndex]->bake(*renderer, shader, inside);
+        for (ShapeHandle h : inside) layer.removeShape(h);
+    }
+
+    // Current frame: baked canvas first, then the live strokes on top
+    void drawCurrent(const Shader& shader, const Shader& textureShader, const glm::mat4& vp) {
+        if (canvasEnabled) canvases[currentIndex]->draw(textureShader, vp);
+        layers[currentIndex].draw(shader, vp);
+    }
+
+    // Previous frame in a single flat color, when onion skinning is on
+    void drawOnion(const Shader& shader, const Shader& textureShader, const glm::mat4& vp, const glm::vec3& tint) {
+        if (!onionEnabled || currentIndex == 0) return;
+
+        if (canvasEnabled) canvases[currentIndex - 1]->draw(textureShader, vp, tint);
+
+        const SCObject& onionLayer = layers[currentIndex - 1];
+        for (ShapeHandle h : onionLayer.getShapeHandles()) {
+            renderer->setOverrideColor(h, tint);
+        }
+
+        onionLayer.draw(shader, vp);
+
+        for (ShapeHandle h : onionLayer.getShapeHandles()) {
+            renderer->clearOverrideColor(h);
+        }
+    }
+
 private:
     Renderer2D* renderer;
     std::vector<SCObject> layers;
     size_t currentIndex{0};
     bool onionEnabled{false};
+
+    std::vector<std::unique_ptr<Canvas>> canvases;
+    bool canvasEnabled{false};
+    int canvasWidth{0}, canvasHeight{0};
+    glm::vec2 canvasMin{0.0f}, canvasMax{0.0f};
+
+    void addCanvas() {
+        canvases.push_back(std::make_unique<Canvas>(canvasWidth, canvasHeight, canvasMin, canvasMax));
+    }
 };
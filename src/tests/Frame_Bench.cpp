@@ -0,0 +1,461 @@
+// Frame_Bench.cpp
+// Whole-frame benchmark over scripted sessions. Micro-benchmarks (sced_bench)
+// time single calls; this times complete frames of real app loops:
+//
+//   stress  N SCObjects (tessellated, instanced and analytic shapes) moving
+//           every frame around a scripted cursor, drawn with drawAll; runs
+//           in this process at N = 1024, 2048, ... --max-objects
+//   paint   New_Paint's loop replaying S scripted strokes over the run,
+//           S = 8, 16, ... --max-strokes
+//   pong    Pong's loop with scripted paddle keys
+//
+// paint and pong run as child processes (new_paint / pong next to this
+// binary) with SCED_HEADLESS set, --frames, --input and --stats, so they
+// measure exactly the shipped loops. Vsync is off and no display is needed:
+//
+//   headless  (default) a real GL context on Mesa's llvmpipe; frame times
+//             include the driver and rasterization, and draw calls, vertices
+//             and bytes uploaded are the renderer's own RenderStats
+//   null      the Null backend: no context or GPU, frame times are the
+//             engine's CPU cost alone, and draw calls, vertices and bytes
+//             uploaded are every command the backend received
+//
+// Reports p50/p95/p99 frame times, draw calls, vertices and bytes uploaded
+// per frame, and how each one grows when the scene doubles (2.00x is
+// linear, 1.00x flat).
+//
+//   frame_bench [--backend headless|null] [--frames N] [--max-objects N]
+//               [--max-strokes N] [--only stress|paint|pong] [--json path]
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../Renderer/RenderBackend.hpp"
+#include "../Renderer/Renderer2D.hpp"
+#include "../Renderer/Shader/Shader.hpp"
+#include "../Renderer/Shapes/CircleShape.hpp"
+#include "../Renderer/Shapes/RectangleShape.hpp"
+#include "../core/FrameStats.h"
+#include "../core/Profiler.h"
+#include "../core/Window.h"
+#include "../input/Input.h"
+#include "../input/InputScript.h"
+#include "../input/ScreenToWorld.hpp"
+#include "../objects/SCObject.hpp"
+
+namespace fs = std::filesystem;
+
+// Window size the scripts are written for (the apps open 1280x720)
+static const int kWidth = 1280;
+static const int kHeight = 720;
+
+struct BenchRun {
+    int sceneSize = 0;
+    std::string backend;    // as the run reported it: "opengl" or "null"
+    FrameStats::Summary summary;
+};
+
+struct Scenario {
+    std::string name;
+    const char* sizeLabel;
+    std::vector<BenchRun> runs;
+};
+
+static void setEnvironment(const char* name, const char* value) {
+#ifdef _WIN32
+    _putenv_s(name, value);
+#else
+    setenv(name, value, 1);
+#endif
+}
+
+// ---------- Scripts ----------
+
+// Cursor sweeping an ellipse around the window, one lap every 4 seconds
+static InputScript stressScript(int frames) {
+    InputScript script;
+    for (int f = 0; f < frames; ++f) {
+        const double angle = f * (2.0 * 3.14159265358979 / 240.0);
+        script.move(f, kWidth * (0.5 + 0.35 * std::cos(angle)), kHeight * (0.5 + 0.35 * std::sin(angle)));
+    }
+    return script;
+}
+
+// Strokes spread evenly over the run, each pressed for two thirds of its
+// slot and dragged across the canvas (clear of the tool buttons on the left)
+static InputScript paintScript(int strokes, int frames) {
+    InputScript script;
+    const int period = std::max(3, frames / strokes);
+    const int length = std::max(2, period * 2 / 3);
+
+    for (int k = 0; k < strokes; ++k) {
+        const int first = k * period;
+        if (first + length >= frames) break;
+
+        const double y = 120.0 + (k * 97) % 480;
+        script.move(first, 450.0, y);
+        script.button(first, GLFW_MOUSE_BUTTON_LEFT, true);
+        for (int j = 1; j <= length; ++j) {
+            script.move(first + j, 450.0 + 700.0 * j / length, y + 40.0 * std::sin(j * 0.3));
+        }
+        script.button(first + length, GLFW_MOUSE_BUTTON_LEFT, false);
+    }
+    return script;
+}
+
+// Both paddles chase the ball: alternate up/down holds of uneven length
+static InputScript pongScript(int frames) {
+    InputScript script;
+    bool up = true;
+    for (int f = 0, hold = 40; f < frames; f += hold, hold = 25 + (hold * 7) % 50, up = !up) {
+        script.key(f, up ? GLFW_KEY_W : GLFW_KEY_S, true);
+        script.key(f, up ? GLFW_KEY_DOWN : GLFW_KEY_UP, true);
+        script.key(f + hold - 1, up ? GLFW_KEY_W : GLFW_KEY_S, false);
+        script.key(f + hold - 1, up ? GLFW_KEY_DOWN : GLFW_KEY_UP, false);
+    }
+    return script;
+}
+
+// ---------- Stress scene ----------
+
+static FrameStats::Summary runStress(int objects, int frames, const Shader& shader, GLFWwindow* window) {
+    Renderer2D renderer;
+    std::vector<SCObject> scene;
+    scene.reserve(objects);
+
+    // A grid over the view, cycling through the three kinds of shape
+    const float aspect = (float)kWidth / (float)kHeight;
+    const int columns = std::max(1, (int)std::sqrt((double)objects * aspect));
+    const int rows = (objects + columns - 1) / columns;
+    std::vector<glm::vec2> homes(objects);
+
+    for (int i = 0; i < objects; ++i) {
+        homes[i] = { (-0.95f + 1.9f * ((float)(i % columns) + 0.5f) / (float)columns) * aspect,
+                     -0.95f + 1.9f * ((float)(i / columns) + 0.5f) / (float)rows };
+
+        const float size = 0.6f / (float)columns;
+        const glm::vec3 color(0.3f + 0.7f * (float)(i % 7) / 6.0f, 0.5f, 1.0f - 0.7f * (float)(i % 5) / 4.0f);
+
+        SCObject& object = scene.emplace_back(&renderer);
+        switch (i % 3) {
+            case 0: object.addShape(CircleShape({0.0f, 0.0f}, size, 16, color)); break;
+            case 1: object.addInstance(CircleShape({0.0f, 0.0f}, size, 24, color)); break;
+            default:
+                object.addShape(RectangleShape({-size, -size * 0.5f}, {size, size * 0.5f}, color).setAnalytic(true));
+                break;
+        }
+        object.setPosition(homes[i]);
+    }
+
+    Input input;
+    input.play(stressScript(frames));
+
+    const glm::mat4 vp = glm::ortho(-aspect, aspect, -1.0f, 1.0f, -1.0f, 1.0f);
+
+    FrameStats stats;
+    stats.reserve(frames);
+    for (int f = 0; f < frames; ++f) {
+        stats.beginFrame();
+        Profiler::beginFrame();
+        Profiler::collectGpuTimings();
+        renderer.beginFrame();
+
+        // Objects lean towards the cursor and spin at their own rates
+        const glm::vec2 cursor = screenToWorld(input.getMouseX(), input.getMouseY(), kWidth, kHeight, aspect);
+        const float t = (float)input.scriptTime();
+        for (int i = 0; i < objects; ++i) {
+            const float phase = t * (1.0f + (float)(i % 11) * 0.1f) + (float)i;
+            const glm::vec2 wobble = 0.02f * glm::vec2(std::cos(phase), std::sin(phase));
+            scene[i].setPosition(homes[i] + 0.1f * (cursor - homes[i]) + wobble);
+            scene[i].setRotation(phase);
+        }
+
+        glViewport(0, 0, kWidth, kHeight);
+        glClear(GL_COLOR_BUFFER_BIT);
+        renderer.drawAll(shader, vp);
+
+        Window::swapBuffers(window);
+        input.endFrame();
+        stats.endFrame(renderer.getStats());
+    }
+
+    return stats.summary();
+}
+
+// ---------- App runs ----------
+
+static bool readSummary(const std::string& path, BenchRun& run) {
+    std::ifstream in(path);
+    if (!in.is_open()) return false;
+
+    nlohmann::json doc = nlohmann::json::parse(in, nullptr, false);
+    if (doc.is_discarded() || !doc.contains("summary")) return false;
+
+    const nlohmann::json& s = doc["summary"];
+    run.sceneSize = doc.value("sceneSize", 0);
+    run.backend = doc.value("backend", "");
+    run.summary.frames = s.value("frames", 0);
+    run.summary.p50 = s.value("p50", 0.0);
+    run.summary.p95 = s.value("p95", 0.0);
+    run.summary.p99 = s.value("p99", 0.0);
+    run.summary.mean = s.value("mean", 0.0);
+    run.summary.max = s.value("max", 0.0);
+    run.summary.drawCalls = s.value("drawCalls", 0.0);
+    run.summary.vertices = s.value("vertices", 0.0);
+    run.summary.bytesUploaded = s.value("bytesUploaded", 0.0);
+    return true;
+}
+
+// Run one of the app binaries on a script; its output goes to a log file
+static bool runApp(const fs::path& binary, const InputScript& script, int frames, const fs::path& work,
+                   const std::string& tag, BenchRun& run) {
+    const fs::path scriptPath = work / (tag + ".input");
+    const fs::path statsPath = work / (tag + ".json");
+    const fs::path logPath = work / (tag + ".log");
+
+    if (!script.save(scriptPath.string())) return false;
+    fs::remove(statsPath);
+
+    const std::string command = "\"" + binary.string() + "\" --frames " + std::to_string(frames) +
+                                " --input \"" + scriptPath.string() + "\" --stats \"" + statsPath.string() +
+                                "\" > \"" + logPath.string() + "\" 2>&1";
+
+    const int status = std::system(command.c_str());
+    if (status != 0 || !readSummary(statsPath.string(), run)) {
+        std::fprintf(stderr, "%s failed (status %d), see %s\n", binary.filename().string().c_str(), status,
+                     logPath.string().c_str());
+        return false;
+    }
+    return true;
+}
+
+// ---------- Report ----------
+
+static void printRun(const Scenario& scenario, const BenchRun& run) {
+    const FrameStats::Summary& s = run.summary;
+    std::printf("%-7s %8s %7d %7d %9.3f %9.3f %9.3f %9.1f %10.0f %11.1f\n", scenario.name.c_str(),
+                scenario.sizeLabel, run.sceneSize, s.frames, s.p50, s.p95, s.p99, s.drawCalls, s.vertices,
+                s.bytesUploaded / 1024.0);
+    std::fflush(stdout);
+}
+
+static double ratio(double to, double from) {
+    return from > 0.0 ? to / from : 0.0;
+}
+
+static nlohmann::ordered_json scalingStep(const BenchRun& from, const BenchRun& to) {
+    return {
+        {"from", from.sceneSize},
+        {"to", to.sceneSize},
+        {"p50", ratio(to.summary.p50, from.summary.p50)},
+        {"p95", ratio(to.summary.p95, from.summary.p95)},
+        {"p99", ratio(to.summary.p99, from.summary.p99)},
+        {"drawCalls", ratio(to.summary.drawCalls, from.summary.drawCalls)},
+        {"vertices", ratio(to.summary.vertices, from.summary.vertices)},
+        {"bytesUploaded", ratio(to.summary.bytesUploaded, from.summary.bytesUploaded)},
+    };
+}
+
+static void printScaling(const Scenario& scenario) {
+    if (scenario.runs.size() < 2) return;
+
+    std::printf("\n%s: growth per doubling of %s (2.00x linear, 1.00x flat)\n", scenario.name.c_str(),
+                scenario.sizeLabel);
+    std::printf("%15s %7s %7s %7s %7s %9s %8s\n", "size", "p50", "p95", "p99", "draws", "vertices", "bytes");
+    for (size_t i = 1; i < scenario.runs.size(); ++i) {
+        const BenchRun& a = scenario.runs[i - 1];
+        const BenchRun& b = scenario.runs[i];
+        char sizes[32];
+        std::snprintf(sizes, sizeof(sizes), "%d -> %d", a.sceneSize, b.sceneSize);
+        std::printf("%15s %6.2fx %6.2fx %6.2fx %6.2fx %8.2fx %7.2fx\n", sizes,
+                    ratio(b.summary.p50, a.summary.p50), ratio(b.summary.p95, a.summary.p95),
+                    ratio(b.summary.p99, a.summary.p99), ratio(b.summary.drawCalls, a.summary.drawCalls),
+                    ratio(b.summary.vertices, a.summary.vertices),
+                    ratio(b.summary.bytesUploaded, a.summary.bytesUploaded));
+    }
+}
+
+static nlohmann::ordered_json toJson(const std::vector<Scenario>& scenarios, const std::string& backend,
+                                     const std::string& glRenderer, int frames) {
+    nlohmann::ordered_json doc;
+    doc["suite"] = "frame_bench";
+    doc["backend"] = backend;
+    if (!glRenderer.empty()) doc["renderer"] = glRenderer;
+    doc["frames"] = frames;
+    doc["unit"] = "ms";
+
+    nlohmann::ordered_json list = nlohmann::ordered_json::array();
+    for (const Scenario& scenario : scenarios) {
+        nlohmann::ordered_json runs = nlohmann::ordered_json::array();
+        for (const BenchRun& run : scenario.runs) {
+            const FrameStats::Summary& s = run.summary;
+            runs.push_back({
+                {"sceneSize", run.sceneSize},
+                {"backend", run.backend},
+                {"frames", s.frames},
+                {"p50", s.p50},
+                {"p95", s.p95},
+                {"p99", s.p99},
+                {"mean", s.mean},
+                {"max", s.max},
+                {"drawCalls", s.drawCalls},
+                {"vertices", s.vertices},
+                {"bytesUploaded", s.bytesUploaded},
+            });
+        }
+
+        nlohmann::ordered_json scaling = nlohmann::ordered_json::array();
+        for (size_t i = 1; i < scenario.runs.size(); ++i) {
+            scaling.push_back(scalingStep(scenario.runs[i - 1], scenario.runs[i]));
+        }
+
+        list.push_back({
+            {"name", scenario.name},
+            {"sizeLabel", scenario.sizeLabel},
+            {"runs", runs},
+            {"scaling", scaling},
+        });
+    }
+    doc["scenarios"] = list;
+    return doc;
+}
+
+int main(int argc, char** argv) {
+    std::string backend = "headless";
+    int frames = 300;
+    int maxObjects = 8192;
+    int maxStrokes = 64;
+    std::string only;
+    std::string jsonPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--backend") == 0 && hasValue) {
+            backend = argv[++i];
+        } else if (std::strcmp(argv[i], "--frames") == 0 && hasValue) {
+            frames = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--max-objects") == 0 && hasValue) {
+            maxObjects = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-strokes") == 0 && hasValue) {
+            maxStrokes = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--only") == 0 && hasValue) {
+            only = argv[++i];
+        } else if (std::strcmp(argv[i], "--json") == 0 && hasValue) {
+            jsonPath = argv[++i];
+        } else {
+            backend.clear();
+            break;
+        }
+    }
+
+    if (backend != "headless" && backend != "null") {
+        std::fprintf(stderr, "usage: %s [--backend headless|null] [--frames N] [--max-objects N] "
+                             "[--max-strokes N] [--only stress|paint|pong] [--json path]\n", argv[0]);
+        return 2;
+    }
+    const WindowMode mode = backend == "null" ? WindowMode::Null : WindowMode::Headless;
+
+    auto wanted = [&](const char* name) { return only.empty() || only == name; };
+
+    // The apps sit next to this binary
+    fs::path binDir = fs::path(argv[0]).parent_path();
+    if (binDir.empty()) binDir = ".";
+    const fs::path work = fs::temp_directory_path() / "sced_frame_bench";
+    fs::create_directories(work);
+    setEnvironment("SCED_HEADLESS", mode == WindowMode::Null ? "null" : "1");
+
+    std::printf("%d frames per run, %s backend, vsync off\n\n", frames, backend.c_str());
+    std::printf("%-7s %8s %7s %7s %9s %9s %9s %9s %10s %11s\n", "scene", "size", "", "frames", "p50 ms",
+                "p95 ms", "p99 ms", "draws/f", "verts/f", "KB/frame");
+
+    std::vector<Scenario> scenarios;
+    std::string glRenderer;
+    int failures = 0;
+
+    if (wanted("stress")) {
+        // Same window setup as the apps get from SCED_HEADLESS
+        if (!Window::initGlfw(mode)) return -1;
+        GLFWwindow* window = Window::createNative(kWidth, kHeight, "Frame Bench", mode);
+        if (!window) return -1;
+
+        if (mode != WindowMode::Null) {
+            glfwMakeContextCurrent(window);
+            glfwSwapInterval(0);
+        }
+        if (!RenderBackend::load(RenderBackend::forMode(mode))) return -1;
+        if (mode != WindowMode::Null) glRenderer = (const char*)glGetString(GL_RENDERER);
+
+        {
+            Shader shader = Shader::fromFiles("Shader/config/flat.vert", "Shader/config/flat.frag");
+
+            Scenario scenario{"stress", "objects"};
+            for (int n = 1024; n <= maxObjects; n *= 2) {
+                BenchRun run;
+                run.sceneSize = n;
+                run.summary = runStress(n, frames, shader, window);
+                run.backend = RenderBackend::active() == BackendKind::Null ? "null" : "opengl";
+                scenario.runs.push_back(run);
+                printRun(scenario, run);
+            }
+            scenarios.push_back(std::move(scenario));
+        }
+
+        RenderBackend::release();
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
+
+    if (wanted("paint")) {
+        Scenario scenario{"paint", "strokes"};
+        for (int strokes = 8; strokes <= maxStrokes; strokes *= 2) {
+            BenchRun run;
+            if (!runApp(binDir / "new_paint", paintScript(strokes, frames), frames, work,
+                        "paint_" + std::to_string(strokes), run)) {
+                ++failures;
+                break;
+            }
+            scenario.runs.push_back(run);
+            printRun(scenario, run);
+        }
+        scenarios.push_back(std::move(scenario));
+    }
+
+    if (wanted("pong")) {
+        Scenario scenario{"pong", "objects"};
+        BenchRun run;
+        if (runApp(binDir / "pong", pongScript(frames), frames, work, "pong", run)) {
+            scenario.runs.push_back(run);
+            printRun(scenario, run);
+        } else {
+            ++failures;
+        }
+        scenarios.push_back(std::move(scenario));
+    }
+
+    for (const Scenario& scenario : scenarios) {
+        printScaling(scenario);
+    }
+
+    if (!jsonPath.empty()) {
+        std::ofstream out(jsonPath);
+        out << toJson(scenarios, backend, glRenderer, frames).dump(2) << '\n';
+        if (!out) {
+            std::fprintf(stderr, "cannot write %s\n", jsonPath.c_str());
+            return 1;
+        }
+        std::printf("\nresults written to %s\n", jsonPath.c_str());
+    }
+
+    return failures == 0 ? 0 : 1;
+}
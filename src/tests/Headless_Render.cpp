@@ -0,0 +1,207 @@
+// Headless_Render.cpp
+// Renders a small scene with no display into an OffscreenTarget and checks
+// the pixels that come back: background, two rectangles and a circle land
+// where they should, and both render paths give the same image. A second
+// scene checks that an instance follows its mesh through compaction and
+// that editing a cloned shape leaves its clone alone; a third that batched
+// draws follow compaction without re-sorting.
+// Runs on Mesa's llvmpipe in CI. Pass a path to also save the frame as PPM.
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../Renderer/OffscreenTarget.hpp"
+#include "../Renderer/Renderer2D.hpp"
+#include "../Renderer/Shader/Shader.hpp"
+#include "../Renderer/Shapes.hpp"
+#include "../Renderer/Transform.hpp"
+#include "../core/Window.h"
+
+static const int kWidth = 200;
+static const int kHeight = 100;
+
+static void render(Renderer2D& renderer, const Shader& shader, const OffscreenTarget& target) {
+    target.bind();
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // One unit per 50 pixels, origin in the middle
+    renderer.drawAll(shader, glm::ortho(-2.0f, 2.0f, -1.0f, 1.0f, -1.0f, 1.0f));
+    glFinish();
+}
+
+// Pixel at (x, y), y counted from the top
+static glm::ivec3 pixel(const std::vector<uint8_t>& pixels, int x, int y) {
+    const uint8_t* p = &pixels[((size_t)y * kWidth + x) * 4];
+    return { p[0], p[1], p[2] };
+}
+
+static int expect(const std::vector<uint8_t>& pixels, int x, int y, glm::ivec3 want, const char* what) {
+    const glm::ivec3 got = pixel(pixels, x, y);
+
+    if (glm::abs(got.x - want.x) > 2 || glm::abs(got.y - want.y) > 2 || glm::abs(got.z - want.z) > 2) {
+        std::printf("  %s at (%d, %d): got %d %d %d, want %d %d %d\n", what, x, y,
+                    got.x, got.y, got.z, want.x, want.y, want.z);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (!Window::initGlfw(WindowMode::Headless)) return -1;
+
+    GLFWwindow* window = Window::createNative(kWidth, kHeight, "Headless Render", WindowMode::Headless);
+    if (!window) return -1;
+
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) return -1;
+
+    std::printf("renderer: %s\n", (const char*)glGetString(GL_RENDERER));
+
+    int failures = 0;
+    {
+        OffscreenTarget target(kWidth, kHeight);
+        Renderer2D renderer;
+        Shader shader = Shader::fromFiles("Shader/config/flat.vert", "Shader/config/flat.frag");
+
+        // Red on the left, green moved to the right, blue circle recolored
+        // yellow in the middle
+        auto red = Shapes::makeRectangle({-1.8f, -0.8f}, {-1.0f, 0.8f}, {1, 0, 0});
+        auto green = Shapes::makeRectangle({-0.4f, -0.4f}, {0.4f, 0.4f}, {0, 1, 0});
+        auto circle = Shapes::makeCircle({0.0f, 0.0f}, 0.5f, 32, {0, 0, 1});
+
+        renderer.addShape(red.data(), (int)red.size());
+        renderer.addShape(green.data(), (int)green.size(),
+                          Transform::translate(Transform::setIdentity(), {1.4f, 0.0f}));
+        ShapeHandle middle = renderer.addShape(circle.data(), (int)circle.size());
+        renderer.setOverrideColor(middle, {1, 1, 0});
+
+        std::vector<uint8_t> perShape, batched;
+
+        renderer.setRenderPath(RenderPath::PerShape);
+        render(renderer, shader, target);
+        target.readPixels(perShape);
+
+        renderer.setRenderPath(RenderPath::Batched);
+        render(renderer, shader, target);
+        target.readPixels(batched);
+
+        // Corners are background; (0, 0) being the top-left checks the row flip
+        failures += expect(perShape, 0, 0, {0, 0, 0}, "background");
+        failures += expect(perShape, kWidth - 1, kHeight - 1, {0, 0, 0}, "background");
+        failures += expect(perShape, 30, 50, {255, 0, 0}, "red rectangle");
+        failures += expect(perShape, 170, 50, {0, 255, 0}, "green rectangle");
+        failures += expect(perShape, 100, 50, {255, 255, 0}, "recolored circle");
+        failures += expect(perShape, 30, 3, {0, 0, 0}, "above the red rectangle");
+
+        int differing = 0;
+        for (size_t i = 0; i < perShape.size(); ++i) {
+            if (perShape[i] != batched[i]) ++differing;
+        }
+        if (differing > 0) {
+            std::printf("  per-shape and batched differ in %d bytes\n", differing);
+            ++failures;
+        }
+
+        if (argc > 1 && target.savePpm(argv[1])) {
+            std::printf("frame written to %s\n", argv[1]);
+        }
+    }
+
+    {
+        // An instance still draws its mesh after compaction moves it down,
+        // and a cloned source can still be edited
+        OffscreenTarget target(kWidth, kHeight);
+        Renderer2D renderer;
+        Shader shader = Shader::fromFiles("Shader/config/flat.vert", "Shader/config/flat.frag");
+
+        // Left one goes, the middle one and the mesh move down over it
+        auto filler = Shapes::makeRectangle({-0.1f, -0.1f}, {0.1f, 0.1f}, {1, 1, 1});
+        ShapeHandle gap = renderer.addShape(filler.data(), (int)filler.size(),
+                                            Transform::translate(Transform::setIdentity(), {-1.4f, 0.0f}));
+        ShapeHandle middle = renderer.addShape(filler.data(), (int)filler.size());
+
+        MeshHandle square = renderer.addMesh(Shapes::makeRectangleMesh({-0.4f, -0.4f}, {0.4f, 0.4f}, {1, 1, 1}));
+        renderer.addInstance(square, Transform::translate(Transform::setIdentity(), {1.4f, 0.0f}), {0, 0, 1});
+
+        renderer.removeShape(gap);
+        if (renderer.compact(1 << 20) == 0) {
+            std::printf("  compaction moved nothing\n");
+            ++failures;
+        }
+
+        // Cloning turns the middle shape into a mesh instance; editing it
+        // afterwards gives it its own copy and leaves the clone white
+        renderer.cloneShape(middle, Transform::translate(Transform::setIdentity(), {0.0f, 0.6f}));
+
+        auto edited = Shapes::makeRectangle({-0.1f, -0.1f}, {0.1f, 0.1f}, {1, 0, 0});
+        if (!renderer.updateVertices(middle, edited.data(), (int)edited.size())) {
+            std::printf("  updateVertices refused a cloned source\n");
+            ++failures;
+        }
+
+        std::vector<uint8_t> compacted;
+        for (RenderPath path : { RenderPath::PerShape, RenderPath::Batched }) {
+            renderer.setRenderPath(path);
+            render(renderer, shader, target);
+            target.readPixels(compacted);
+
+            // Outside the small square, so drawing the wrong range shows
+            failures += expect(compacted, 185, 50, {0, 0, 255}, "compacted instance");
+            failures += expect(compacted, 100, 50, {255, 0, 0}, "edited source");
+            failures += expect(compacted, 100, 20, {255, 255, 255}, "clone of the source");
+            failures += expect(compacted, 30, 50, {0, 0, 0}, "removed shape");
+        }
+    }
+
+    for (bool culling : { false, true }) {
+        // Compaction after the batched lists exist patches their offsets in
+        // place. The shape is recolored after it moved, so a stale offset
+        // would draw its old, still green, copy.
+        OffscreenTarget target(kWidth, kHeight);
+        Renderer2D renderer;
+        Shader shader = Shader::fromFiles("Shader/config/flat.vert", "Shader/config/flat.frag");
+        renderer.setRenderPath(RenderPath::Batched);
+        renderer.setCulling(culling);
+        renderer.setCompactionBudget(0);
+
+        auto green = Shapes::makeRectangle({-0.1f, -0.1f}, {0.1f, 0.1f}, {0, 1, 0});
+        ShapeHandle gap = renderer.addShape(green.data(), (int)green.size(),
+                                            Transform::translate(Transform::setIdentity(), {-1.4f, 0.0f}));
+        ShapeHandle moved = renderer.addShape(green.data(), (int)green.size(),
+                                              Transform::translate(Transform::setIdentity(), {1.4f, 0.0f}));
+
+        renderer.removeShape(gap);
+        render(renderer, shader, target);
+
+        renderer.beginFrame();
+        if (renderer.compact(1 << 20) == 0) {
+            std::printf("  compaction moved nothing\n");
+            ++failures;
+        }
+
+        auto red = Shapes::makeRectangle({-0.1f, -0.1f}, {0.1f, 0.1f}, {1, 0, 0});
+        renderer.updateVertices(moved, red.data(), (int)red.size());
+        render(renderer, shader, target);
+
+        if (renderer.getStats().drawListSorts != 0) {
+            std::printf("  compaction re-sorted the draw list (culling %s)\n", culling ? "on" : "off");
+            ++failures;
+        }
+
+        std::vector<uint8_t> pixels;
+        target.readPixels(pixels);
+        failures += expect(pixels, 170, 50, {255, 0, 0}, "shape moved by compaction");
+        failures += expect(pixels, 30, 50, {0, 0, 0}, "removed shape");
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+
+    std::printf("headless render: %s (%d failures)\n", failures == 0 ? "ok" : "FAILED", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -7,6 +7,9 @@
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 #include "../Renderer/Shapes/IShape2D.hpp"
 #include "../Renderer/Shapes/RectangleShape.hpp"
@@ -18,9 +21,13 @@
 #include "../Renderer/Shader/Shader.hpp"
 #include "../Renderer/Transform.hpp"
 #include "../Renderer/Vertex2D.hpp"
+#include "../Renderer/StrokeBuilder.hpp"
+#include "../Renderer/RenderBackend.hpp"
 
 #include "../objects/SCObject.hpp"
 #include "../core/Window.h"
+#include "../core/FrameStats.h"
+#include "../core/Profiler.h"
 #include "../input/Input.h"
 #include "../converter/SCArch.cpp"
 #include "../color/SColor.hpp"
@@ -36,74 +43,89 @@
 // -------------------------------------------------------------
 struct Brush {
     float radius;
-    float spacing;
     glm::vec3 color;
     int   segments;
 
+    CircleShape shape(const glm::vec2& center) const {
+        return CircleShape(center, radius, segments, color);
+    }
+
     std::vector<Vertex2D> generateVertices(const glm::vec2& center) const {
-        CircleShape circle(center, radius, segments, color);
-        return circle.generateVertices();
+        return shape(center).generateVertices();
     }
 };
 
 // -------------------------------------------------------------
-// Painting logic (unchanged semantics, now using LayerStack)
+// Painting logic: one continuous stroke mesh per mouse press
 // -------------------------------------------------------------
 void handlePainting(const FrameState& fs,
-                    Brush& brush,
-                    SCObject& strokeLayer,
-                    glm::vec2& lastPlacedPos,
-                    bool& lastPosValid,
+                    const Brush& brush,
+                    StrokeBuilder& stroke,
                     bool mouseWasDown)
 {
-    if (fs.mouseDown && !mouseWasDown) {
-        auto verts = brush.generateVertices(fs.worldPos);
-        strokeLayer.addShape(verts);
-        lastPlacedPos = fs.worldPos;
-        lastPosValid  = true;
-    }
-    else if (fs.mouseDown && mouseWasDown) {
-        if (lastPosValid) {
-            float dist = glm::distance(fs.worldPos, lastPlacedPos);
-            if (dist >= brush.spacing) {
-                auto verts = brush.generateVertices(fs.worldPos);
-                strokeLayer.addShape(verts);
-                lastPlacedPos = fs.worldPos;
-            }
-        } else {
-            auto verts = brush.generateVertices(fs.worldPos);
-            strokeLayer.addShape(verts);
-            lastPlacedPos = fs.worldPos;
-            lastPosValid  = true;
-        }
+    if (fs.mouseDown && (!mouseWasDown || !stroke.active())) {
+        stroke.begin(fs.worldPos, brush.radius, brush.color);
     }
-    else if (!fs.mouseDown && mouseWasDown) {
-        lastPosValid = false;
+    else if (fs.mouseDown) {
+        stroke.addPoint(fs.worldPos);
     }
 }
 
 // -------------------------------------------------------------
 // main
 // -------------------------------------------------------------
-int main() {
-    if (!glfwInit()) return -1;
+int main(int argc, char** argv) {
+    // --frames N stops after N frames; SCED_HEADLESS=null runs on the Null
+    // backend with no GL at all, to time the engine side alone. --input
+    // replays an InputScript and --stats writes per-frame numbers as JSON.
+    int frameLimit = 0;
+    const char* scriptPath = nullptr;
+    const char* statsPath = nullptr;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--frames") == 0) frameLimit = std::atoi(argv[i + 1]);
+        if (std::strcmp(argv[i], "--input") == 0) scriptPath = argv[i + 1];
+        if (std::strcmp(argv[i], "--stats") == 0) statsPath = argv[i + 1];
+    }
+
+    const WindowMode mode = Window::modeFromEnvironment();
+    if (!Window::initGlfw(mode)) return -1;
 
-    Window win(1280, 720, "SCED Paint Test");
+    Window win(1280, 720, "SCED Paint Test", mode);
     GLFWwindow* window = win.getNativeWindow();
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) return -1;
+    if (!RenderBackend::load(RenderBackend::forMode(mode))) return -1;
+    if (frameLimit > 0 && mode != WindowMode::Null) glfwSwapInterval(0);
+
+    // Analytic shapes fade their edges through alpha
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     Renderer2D renderer;
     Shader shader = Shader::fromFiles("Shader/config/flat.vert", "Shader/config/flat.frag");
+    const Shader::LoadInfo flatLoad = Shader::lastLoad();
+    Shader textureShader = Shader::fromFiles("Shader/config/textured.vert", "Shader/config/textured.frag");
+    const Shader::LoadInfo texturedLoad = Shader::lastLoad();
+
+    std::printf("Shader setup: %.2f ms (%s)\n", flatLoad.milliseconds + texturedLoad.milliseconds,
+                flatLoad.fromBinaryCache && texturedLoad.fromBinaryCache ? "warm, cached binaries" : "cold, compiled");
 
     Input input;
     input.initialize(window);
 
+    if (scriptPath) {
+        InputScript script;
+        if (!script.load(scriptPath)) return -1;
+        input.play(script);
+    }
+
     // ---------------------------------------------------------
     // Layers (timeline of frames)
     // ---------------------------------------------------------
     LayerStack layers(&renderer);      // starts with one empty SCObject layer
 
+    // Finished strokes are baked into a texture per frame on mouse up
+    layers.enableCanvas(2048, 1024, {-2.0f, -1.0f}, {2.0f, 1.0f});
+
     // ---------------------------------------------------------
     // Background
     // ---------------------------------------------------------
@@ -143,18 +165,16 @@ int main() {
     // ---------------------------------------------------------
     Brush brush;
     brush.radius   = 0.01f;
-    brush.spacing  = 0.00001f;
     brush.color    = SColor::normalizeColor(0, 0, 0);
     brush.segments = 36;
 
     bool      mouseWasDown  = false;
-    glm::vec2 lastPlacedPos = glm::vec2(0.0f, 0.0f);
-    bool      lastPosValid  = false;
+    StrokeBuilder stroke(brush.segments / 2);
 
     // ---------------------------------------------------------
     // UI Manager
     // ---------------------------------------------------------
-    UIManager ui;
+    UIManager ui(&renderer);
     ui.addButton(&frameBtn);
 
     // ---------------------------------------------------------
@@ -164,7 +184,7 @@ int main() {
     // Red
     SCObject redButton(&renderer);
     auto redBtnHandleShape = redButton.addShape(
-        CircleShape({-1.7f, .9f}, .05f, 64, SColor::normalizeColor(255, 163, 163))
+        CircleShape({-1.7f, .9f}, .05f, 64, SColor::normalizeColor(255, 163, 163)).setAnalytic(true)
     );
     SCButton redBtn(&redButton, redBtnHandleShape, &renderer);
     bool toggledRed = false;
@@ -184,7 +204,7 @@ int main() {
     // Blue
     SCObject blueButton(&renderer);
     auto blueBtnHandleShape = blueButton.addShape(
-        CircleShape({-1.56f, .9f}, .05f, 64, SColor::normalizeColor(163, 163, 255))
+        CircleShape({-1.56f, .9f}, .05f, 64, SColor::normalizeColor(163, 163, 255)).setAnalytic(true)
     );
     SCButton blueBtn(&blueButton, blueBtnHandleShape, &renderer);
     bool toggledBlue = false;
@@ -204,7 +224,7 @@ int main() {
     // Yellow
     SCObject yellowButton(&renderer);
     auto yellowBtnHandleShape = yellowButton.addShape(
-        CircleShape({-1.7f, 0.76f}, .05f, 64, SColor::normalizeColor(220, 220, 163))
+        CircleShape({-1.7f, 0.76f}, .05f, 64, SColor::normalizeColor(220, 220, 163)).setAnalytic(true)
     );
     SCButton yellowBtn(&yellowButton, yellowBtnHandleShape, &renderer);
     bool toggledYellow = false;
@@ -223,7 +243,7 @@ int main() {
     // Green
     SCObject greenButton(&renderer);
     auto greenBtnHandleShape = greenButton.addShape(
-        CircleShape({-1.56f, 0.76f}, .05f, 64, SColor::normalizeColor(163, 255, 163))
+        CircleShape({-1.56f, 0.76f}, .05f, 64, SColor::normalizeColor(163, 255, 163)).setAnalytic(true)
     );
     SCButton greenBtn(&greenButton, greenBtnHandleShape, &renderer);
     bool toggledGreen = false;
@@ -242,7 +262,7 @@ int main() {
     // Purple
     SCObject purpleButton(&renderer);
     auto purpleBtnHandleShape = purpleButton.addShape(
-        CircleShape({-1.7f, 0.62f}, .05f, 64, SColor::normalizeColor(200, 100, 200))
+        CircleShape({-1.7f, 0.62f}, .05f, 64, SColor::normalizeColor(200, 100, 200)).setAnalytic(true)
     );
     SCButton purpleBtn(&purpleButton, purpleBtnHandleShape, &renderer);
     bool toggledPurple = false;
@@ -261,7 +281,7 @@ int main() {
     // Orange
     SCObject orangeButton(&renderer);
     auto orangeBtnHandleShape = orangeButton.addShape(
-        CircleShape({-1.56f, 0.62f}, .05f, 64, SColor::normalizeColor(255, 177, 102))
+        CircleShape({-1.56f, 0.62f}, .05f, 64, SColor::normalizeColor(255, 177, 102)).setAnalytic(true)
     );
     SCButton orangeBtn(&orangeButton, orangeBtnHandleShape, &renderer);
     bool toggledOrange = false;
@@ -280,7 +300,7 @@ int main() {
     // Brown
     SCObject brownButton(&renderer);
     auto brownBtnHandleShape = brownButton.addShape(
-        CircleShape({-1.7f, 0.48f}, .05f, 64, SColor::normalizeColor(185, 150, 124))
+        CircleShape({-1.7f, 0.48f}, .05f, 64, SColor::normalizeColor(185, 150, 124)).setAnalytic(true)
     );
     SCButton brownBtn(&brownButton, brownBtnHandleShape, &renderer);
     bool toggledBrown = false;
@@ -299,7 +319,7 @@ int main() {
     // White
     SCObject whiteButton(&renderer);
     auto whiteBtnHandleShape = whiteButton.addShape(
-        CircleShape({-1.56f, 0.48f}, .05f, 64, SColor::normalizeColor(230, 230, 230))
+        CircleShape({-1.56f, 0.48f}, .05f, 64, SColor::normalizeColor(230, 230, 230)).setAnalytic(true)
     );
     SCButton whiteBtn(&whiteButton, whiteBtnHandleShape, &renderer);
     bool toggledWhite = false;
@@ -321,17 +341,13 @@ int main() {
     SCObject upArrowButton(&renderer);
     glm::vec2 upCenter = { -1.4f, 0.9f };
 
-    CircleShape upBgCircleLocal(
-        {0.0f, 0.0f},
+    CircleShape upBgCircle(
+        upCenter,
         0.08f,
         64,
         SColor::normalizeColor(255, 255, 255)
     );
-
-    auto upBgVerts = upBgCircleLocal.generateVertices();
-    for (auto& v : upBgVerts) {
-        v.pos += upCenter;
-    }
+    upBgCircle.setAnalytic(true);
 
     std::vector<Vertex2D> upArrow = {
         { glm::vec2( 0.00f,  0.04f), glm::vec3(0,0,0) },
@@ -343,7 +359,7 @@ int main() {
         v.pos += upCenter;
     }
 
-    ShapeHandle upBgHandle = upArrowButton.addShape(upBgVerts);
+    ShapeHandle upBgHandle = upArrowButton.addShape(upBgCircle);
     ShapeHandle arrowUpHandle = upArrowButton.addShape(upArrow);
 
     SCButton arrowUpBtn(&upArrowButton, upBgHandle, &renderer);
@@ -366,17 +382,13 @@ int main() {
     SCObject dwnArrowButton(&renderer);
     glm::vec2 dwnCenter = { -1.4f, 0.7f };
 
-    CircleShape bgCircleLocal(
-        {0.0f, 0.0f},
+    CircleShape bgCircle(
+        dwnCenter,
         0.08f,
         64,
         SColor::normalizeColor(255, 255, 255)
     );
-
-    auto bgVerts = bgCircleLocal.generateVertices();
-    for (auto& v : bgVerts) {
-        v.pos += dwnCenter;
-    }
+    bgCircle.setAnalytic(true);
 
     std::vector<Vertex2D> downArrow = {
         { glm::vec2(-0.03f, 0.02f), glm::vec3(0,0,0) },
@@ -388,7 +400,7 @@ int main() {
         v.pos += dwnCenter;
     }
 
-    ShapeHandle bgH    = dwnArrowButton.addShape(bgVerts);
+    ShapeHandle bgH    = dwnArrowButton.addShape(bgCircle);
     ShapeHandle arrowH = dwnArrowButton.addShape(downArrow);
 
     SCButton arrowDownBtn(&dwnArrowButton, bgH, &renderer);
@@ -411,12 +423,27 @@ int main() {
     bool prevRight = false;
     bool prevLeft  = false;
     bool prevO     = false;
+    bool prevB     = false;
+
+    // Frame timing, shown in the title so both render paths can be compared
+    double statsTimer  = glfwGetTime();
+    int    statsFrames = 0;
+
+    FrameStats stats;
+    if (frameLimit > 0) stats.reserve(frameLimit);
+    int frames = 0;
+    int strokes = 0;
+    RenderBackend::resetCounts();
 
     // ---------------------------------------------------------
     // Main loop
     // ---------------------------------------------------------
-    while (!win.shouldClose()) {
+    while (!win.shouldClose() && (frameLimit <= 0 || frames < frameLimit)) {
+        if (frameLimit > 0) stats.beginFrame();
         glfwPollEvents();
+        Profiler::beginFrame();
+        Profiler::collectGpuTimings();
+        renderer.beginFrame();
 
         int width = 0, height = 0;
         glfwGetFramebufferSize(window, &width, &height);
@@ -428,16 +455,18 @@ int main() {
         glClear(GL_COLOR_BUFFER_BIT);
 
         // Snapshot of input for this frame (world pos, mouse, etc.)
-        FrameState fi = updateFrameInput(input, window, width, height, aspect, mouseWasDown);
+        FrameState fi = updateFrameInput(input, width, height, aspect, mouseWasDown);
 
         // Frame navigation + onion toggle (edge triggered)
-        int rightState = glfwGetKey(window, GLFW_KEY_RIGHT);
-        int leftState  = glfwGetKey(window, GLFW_KEY_LEFT);
-        int oState     = glfwGetKey(window, GLFW_KEY_O);
+        bool rightState = input.isKeyPressed(GLFW_KEY_RIGHT);
+        bool leftState  = input.isKeyPressed(GLFW_KEY_LEFT);
+        bool oState     = input.isKeyPressed(GLFW_KEY_O);
+        bool bState     = input.isKeyPressed(GLFW_KEY_B);
 
-        bool justRight = (rightState == GLFW_PRESS && !prevRight);
-        bool justLeft  = (leftState  == GLFW_PRESS && !prevLeft);
-        bool justO     = (oState     == GLFW_PRESS && !prevO);
+        bool justRight = (rightState && !prevRight);
+        bool justLeft  = (leftState  && !prevLeft);
+        bool justO     = (oState     && !prevO);
+        bool justB     = (bState     && !prevB);
 
         if (justRight) {
             layers.next();
@@ -448,10 +477,15 @@ int main() {
         if (justO) {
             layers.toggleOnion();
         }
+        if (justB) {
+            bool batched = renderer.getRenderPath() == RenderPath::Batched;
+            renderer.setRenderPath(batched ? RenderPath::PerShape : RenderPath::Batched);
+        }
 
-        prevRight = (rightState == GLFW_PRESS);
-        prevLeft  = (leftState  == GLFW_PRESS);
-        prevO     = (oState     == GLFW_PRESS);
+        prevRight = rightState;
+        prevLeft  = leftState;
+        prevO     = oState;
+        prevB     = bState;
 
         // Update all UI buttons with this frame's input
         ui.updateAll(fi, mouseWasDown);
@@ -461,7 +495,14 @@ int main() {
 
         // Paint only if not over UI
         if (!overUI) {
-            handlePainting(fi, brush, layers.current(), lastPlacedPos, lastPosValid, mouseWasDown);
+            handlePainting(fi, brush, stroke, mouseWasDown);
+        }
+
+        // Stroke finished: bake it so it no longer costs anything per frame
+        if (!fi.mouseDown && mouseWasDown && stroke.active()) {
+            layers.current().addShape(stroke.finish());
+            layers.commit(shader);
+            ++strokes;
         }
 
         mouseWasDown = fi.mouseDown;
@@ -474,20 +515,20 @@ int main() {
         background.draw(shader, vp);
 
         // Onion layer (previous frame) if enabled
-        if (const SCObject* onion = layers.onion()) {
-            for (ShapeHandle h : onion->getShapeHandles()) {
-                renderer.setOverrideColor(h, SColor::normalizeColor(200, 200, 200));
-            }
-        
-            onion->draw(shader, vp);
-        
-            for (ShapeHandle h : onion->getShapeHandles()) {
-                renderer.clearOverrideColor(h);
-            }
+        layers.drawOnion(shader, textureShader, vp, SColor::normalizeColor(200, 200, 200));
+
+        // Current drawing layer (baked canvas), then the stroke in progress
+        layers.drawCurrent(shader, textureShader, vp);
+
+        if (stroke.active()) {
+            renderer.drawDynamic(shader, vp, stroke.mesh());
         }
 
-        // Current drawing layer
-        layers.current().draw(shader, vp);
+        // Live brush preview under the cursor, streamed fresh every frame
+        if (!overUI) {
+            auto preview = brush.generateVertices(fi.worldPos);
+            renderer.drawDynamic(shader, vp, preview.data(), (int)preview.size());
+        }
 
         // Frame border
         frameObj.draw(shader, vp);
@@ -495,10 +536,42 @@ int main() {
         // All UI buttons
         ui.drawAll(shader, vp);
 
-        glfwSwapBuffers(window);
+        Window::swapBuffers(window);
         input.endFrame();
+
+        ++frames;
+        if (frameLimit > 0) stats.endFrame(renderer.getStats());
+        ++statsFrames;
+        double now = glfwGetTime();
+        if (now - statsTimer >= 0.5) {
+            double frameMs = 1000.0 * (now - statsTimer) / statsFrames;
+            RenderStats rs = renderer.getStats();
+            char title[224];
+            std::snprintf(title, sizeof(title), "SCED Paint Test [%s] %.2f ms, %u draws, %zu shapes (%u culled), %.1f KB uploaded, %u fence waits",
+                          renderer.getRenderPath() == RenderPath::Batched ? "batched" : "per-shape",
+                          frameMs, rs.drawCalls, renderer.shapeCount(), rs.shapesCulled, rs.bytesUploaded / 1024.0,
+                          rs.fenceWaits);
+            glfwSetWindowTitle(window, title);
+            statsTimer  = now;
+            statsFrames = 0;
+        }
+    }
+
+    if (frameLimit > 0 && frames > 0) {
+        stats.print("Paint");
+        if (statsPath && !stats.writeJson(statsPath, "paint", strokes)) {
+            std::fprintf(stderr, "cannot write %s\n", statsPath);
+        }
+
+        if (RenderBackend::active() == BackendKind::Null) {
+            const RenderBackend::Counts c = RenderBackend::counts();
+            std::printf("Null backend per frame: %.1f draws, %.1f uniforms, %.1f state changes, %.0f bytes uploaded\n",
+                        (double)c.drawCalls / frames, (double)c.uniformUploads / frames,
+                        (double)c.stateChanges / frames, (double)c.bytesUploaded / frames);
+        }
     }
 
+    RenderBackend::release();
     glfwTerminate();
     return 0;
 }
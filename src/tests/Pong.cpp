@@ -4,6 +4,9 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <memory>
 #include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 #include "../Renderer/Shapes/RectangleShape.hpp"
 #include "../Renderer/Shapes/CircleShape.hpp"
@@ -11,25 +14,41 @@
 #include "../Renderer/Shader/Shader.hpp"
 #include "../Renderer/Transform.hpp"
 #include "../Renderer/Vertex2D.hpp"
+#include "../Renderer/RenderBackend.hpp"
 
 #include "../objects/SCObject.hpp"
 #include "../core/Window.h"
+#include "../core/FixedTimestep.h"
+#include "../core/FrameStats.h"
+#include "../core/Profiler.h"
 #include "../input/Input.h"
 #include "../color/SColor.hpp"
 
 
-int main() {
-    if (!glfwInit()) return -1;
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+int main(int argc, char** argv) {
+    // --frames N stops after N frames; SCED_HEADLESS=null runs on the Null
+    // backend with no GL at all, to time the engine side alone. --input
+    // replays an InputScript and --stats writes per-frame numbers as JSON.
+    int frameLimit = 0;
+    const char* scriptPath = nullptr;
+    const char* statsPath = nullptr;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--frames") == 0) frameLimit = std::atoi(argv[i + 1]);
+        if (std::strcmp(argv[i], "--input") == 0) scriptPath = argv[i + 1];
+        if (std::strcmp(argv[i], "--stats") == 0) statsPath = argv[i + 1];
+    }
+
+    const WindowMode mode = Window::modeFromEnvironment();
+    if (!Window::initGlfw(mode)) return -1;
 
-    GLFWwindow* window = glfwCreateWindow(1280, 720, "SCED Pong Demo", nullptr, nullptr);
+    GLFWwindow* window = Window::createNative(1280, 720, "SCED Pong Demo", mode);
     if (!window) return -1;
 
-    glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) return -1;
+    if (mode != WindowMode::Null) {
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(frameLimit > 0 ? 0 : 1);
+    }
+    if (!RenderBackend::load(RenderBackend::forMode(mode))) return -1;
 
     Renderer2D renderer;
     Shader shader = Shader::fromFiles("Shader/config/flat.vert", "Shader/config/flat.frag");
@@ -37,6 +56,12 @@ int main() {
     Input input;
     input.initialize(window);
 
+    if (scriptPath) {
+        InputScript script;
+        if (!script.load(scriptPath)) return -1;
+        input.play(script);
+    }
+
     int width = 0, height = 0;
 
     // ----------------------------------------
@@ -90,10 +115,26 @@ int main() {
     // ----------------------------------------
     // TIME TRACKING
     // ----------------------------------------
-    double lastTime = glfwGetTime();
-
-    while (!glfwWindowShouldClose(window)) {
+    // Logic at a fixed 120 Hz whatever the refresh rate; objects are drawn
+    // interpolated between the last two steps
+    FixedTimestep timestep(120.0, 8);
+    double lastTime = input.isScripted() ? input.scriptTime() : glfwGetTime();
+
+    paddleLeft.saveState();
+    paddleRight.saveState();
+    ball.saveState();
+
+    FrameStats stats;
+    if (frameLimit > 0) stats.reserve(frameLimit);
+    int frames = 0;
+    RenderBackend::resetCounts();
+
+    while (!glfwWindowShouldClose(window) && (frameLimit <= 0 || frames < frameLimit)) {
+        if (frameLimit > 0) stats.beginFrame();
         glfwPollEvents();
+        Profiler::beginFrame();
+        Profiler::collectGpuTimings();
+        renderer.beginFrame();
 
         glfwGetFramebufferSize(window, &width, &height);
         if (height == 0) height = 1;
@@ -105,83 +146,98 @@ int main() {
 
         glm::mat4 vp = glm::ortho(-aspect, aspect, -1.f, 1.f, -1.f, 1.f);
 
-        double now = glfwGetTime();
-        float dt = float(now - lastTime);
+        double now = input.isScripted() ? input.scriptTime() : glfwGetTime();
+        int steps = timestep.advance(now - lastTime);
         lastTime = now;
 
-        // ----------------------------------------
-        // PADDLE INPUT
-        // ----------------------------------------
-        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-            paddleLeftPos.y += paddleSpeed * dt;
-        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-            paddleLeftPos.y -= paddleSpeed * dt;
-
-        if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
-            paddleRightPos.y += paddleSpeed * dt;
-        if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
-            paddleRightPos.y -= paddleSpeed * dt;
-
-        // Clamp paddles
-        if (paddleLeftPos.y > 0.8f) paddleLeftPos.y = 0.8f;
-        if (paddleLeftPos.y < -0.8f) paddleLeftPos.y = -0.8f;
-
-        if (paddleRightPos.y > 0.8f) paddleRightPos.y = 0.8f;
-        if (paddleRightPos.y < -0.8f) paddleRightPos.y = -0.8f;
-
-        paddleLeft.setPosition(paddleLeftPos);
-        paddleRight.setPosition(paddleRightPos);
-
-        // ----------------------------------------
-        // BALL UPDATE
-        // ----------------------------------------
-        ballPos += ballVel * dt;
-        ball.setPosition(ballPos);
+        const float dt = float(timestep.step());
+
+        for (int step = 0; step < steps; ++step) {
+            paddleLeft.saveState();
+            paddleRight.saveState();
+            ball.saveState();
+
+            // ----------------------------------------
+            // PADDLE INPUT
+            // ----------------------------------------
+            if (input.isKeyPressed(GLFW_KEY_W))
+                paddleLeftPos.y += paddleSpeed * dt;
+            if (input.isKeyPressed(GLFW_KEY_S))
+                paddleLeftPos.y -= paddleSpeed * dt;
+
+            if (input.isKeyPressed(GLFW_KEY_UP))
+                paddleRightPos.y += paddleSpeed * dt;
+            if (input.isKeyPressed(GLFW_KEY_DOWN))
+                paddleRightPos.y -= paddleSpeed * dt;
+
+            // Clamp paddles
+            if (paddleLeftPos.y > 0.8f) paddleLeftPos.y = 0.8f;
+            if (paddleLeftPos.y < -0.8f) paddleLeftPos.y = -0.8f;
+
+            if (paddleRightPos.y > 0.8f) paddleRightPos.y = 0.8f;
+            if (paddleRightPos.y < -0.8f) paddleRightPos.y = -0.8f;
+
+            paddleLeft.setPosition(paddleLeftPos);
+            paddleRight.setPosition(paddleRightPos);
+
+            // ----------------------------------------
+            // BALL UPDATE
+            // ----------------------------------------
+            ballPos += ballVel * dt;
+            ball.setPosition(ballPos);
+
+            // Wall bounce
+            if (ballPos.y > top) {
+                ballPos.y = top;
+                ballVel.y = -ballVel.y;
+            }
+            if (ballPos.y < bottom) {
+                ballPos.y = bottom;
+                ballVel.y = -ballVel.y;
+            }
 
-        // Wall bounce
-        if (ballPos.y > top) {
-            ballPos.y = top;
-            ballVel.y = -ballVel.y;
-        }
-        if (ballPos.y < bottom) {
-            ballPos.y = bottom;
-            ballVel.y = -ballVel.y;
-        }
+            // ----------------------------------------
+            // PADDLE COLLISION
+            // ----------------------------------------
+            float paddleHalfHeight = 0.2f;
+            float paddleHalfWidth  = 0.05f;
+            float ballRadius       = 0.06f;
+
+            // Left paddle collision
+            if (ballPos.x - ballRadius < paddleLeftPos.x + paddleHalfWidth) {
+                if (ballPos.y < paddleLeftPos.y + paddleHalfHeight &&
+                    ballPos.y > paddleLeftPos.y - paddleHalfHeight)
+                {
+                    ballPos.x = paddleLeftPos.x + paddleHalfWidth + ballRadius;
+                    ballVel.x = -ballVel.x;
+                }
+            }
 
-        // ----------------------------------------
-        // PADDLE COLLISION
-        // ----------------------------------------
-        float paddleHalfHeight = 0.2f;
-        float paddleHalfWidth  = 0.05f;
-        float ballRadius       = 0.06f;
-
-        // Left paddle collision
-        if (ballPos.x - ballRadius < paddleLeftPos.x + paddleHalfWidth) {
-            if (ballPos.y < paddleLeftPos.y + paddleHalfHeight &&
-                ballPos.y > paddleLeftPos.y - paddleHalfHeight)
-            {
-                ballPos.x = paddleLeftPos.x + paddleHalfWidth + ballRadius;
-                ballVel.x = -ballVel.x;
+            // Right paddle collision
+            if (ballPos.x + ballRadius > paddleRightPos.x - paddleHalfWidth) {
+                if (ballPos.y < paddleRightPos.y + paddleHalfHeight &&
+                    ballPos.y > paddleRightPos.y - paddleHalfHeight)
+                {
+                    ballPos.x = paddleRightPos.x - paddleHalfWidth - ballRadius;
+                    ballVel.x = -ballVel.x;
+                }
             }
-        }
 
-        // Right paddle collision
-        if (ballPos.x + ballRadius > paddleRightPos.x - paddleHalfWidth) {
-            if (ballPos.y < paddleRightPos.y + paddleHalfHeight &&
-                ballPos.y > paddleRightPos.y - paddleHalfHeight)
-            {
-                ballPos.x = paddleRightPos.x - paddleHalfWidth - ballRadius;
-                ballVel.x = -ballVel.x;
+            // ----------------------------------------
+            // SCORING (RESET)
+            // ----------------------------------------
+            if (ballPos.x > aspect + 0.5f || ballPos.x < -aspect - 0.5f) {
+                ballPos = {0.0f, 0.0f};
+                ballVel = {0.9f, 0.4f};
+                ball.setPosition(ballPos);
+                ball.saveState();
             }
         }
 
-        // ----------------------------------------
-        // SCORING (RESET)
-        // ----------------------------------------
-        if (ballPos.x > aspect + 0.5f || ballPos.x < -aspect - 0.5f) {
-            ballPos = {0.0f, 0.0f};
-            ballVel = {0.9f, 0.4f};
-        }
+        const float alpha = timestep.alpha();
+        paddleLeft.interpolate(alpha);
+        paddleRight.interpolate(alpha);
+        ball.interpolate(alpha);
 
         // ----------------------------------------
         // DRAW
@@ -190,10 +246,27 @@ int main() {
         paddleRight.draw(shader, vp);
         ball.draw(shader, vp);
 
-        glfwSwapBuffers(window);
+        Window::swapBuffers(window);
         input.endFrame();
+        ++frames;
+        if (frameLimit > 0) stats.endFrame(renderer.getStats());
+    }
+
+    if (frameLimit > 0 && frames > 0) {
+        stats.print("Pong");
+        if (statsPath && !stats.writeJson(statsPath, "pong", 3)) {
+            std::fprintf(stderr, "cannot write %s\n", statsPath);
+        }
+
+        if (RenderBackend::active() == BackendKind::Null) {
+            const RenderBackend::Counts c = RenderBackend::counts();
+            std::printf("Null backend per frame: %.1f draws, %.1f uniforms, %.1f state changes\n",
+                        (double)c.drawCalls / frames, (double)c.uniformUploads / frames,
+                        (double)c.stateChanges / frames);
+        }
     }
 
+    RenderBackend::release();
     glfwDestroyWindow(window);
     glfwTerminate();
     return 0;
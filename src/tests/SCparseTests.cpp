@@ -26,6 +26,22 @@ int main()
         return 1;
     }
 
+    if (rectangle->isAnalytic() || circle->isAnalytic()) {
+        std::cerr << "SCParse marked shapes analytic without \"analytic\": true" << '\n';
+        return 1;
+    }
+
+    auto rounded = SCParse::getShape("analytic_rect");
+    SdfPrimitive prim;
+    glm::vec2 origin;
+    glm::vec3 color;
+
+    if (!rounded->sdfPrimitive(prim, origin, color) ||
+        prim.kind != SdfKind::RoundedRect || prim.cornerRadius != 0.05f) {
+        std::cerr << "SCParse did not build an analytic rounded rectangle" << '\n';
+        return 1;
+    }
+
     bool missingShapeThrew = false;
     try {
         (void)SCParse::getShape("does_not_exist");
@@ -0,0 +1,572 @@
+// Sced_Bench.cpp
+// Micro-benchmarks for the renderer and scene layers at 1k, 10k, 100k and 1M
+// shapes. Every benchmark runs warmup repetitions, then collects timed
+// samples (a batch of up to 1000 operations each, or one call for
+// whole-scene operations) and reports ns/op percentiles.
+//
+// GL calls go to the Null backend, so no display, context or GPU is needed
+// and drawAll measures only the engine's submission work. Results print as a
+// table; --json writes them for comparing releases.
+//
+//   sced_bench [--json path|-] [--max-shapes N] [--reps N] [--warmup N]
+//              [--budget seconds] [--filter text]
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Renderer/RenderBackend.hpp"
+#include "../Renderer/Renderer2D.hpp"
+#include "../Renderer/Shader/Shader.hpp"
+#include "../Renderer/Shapes.hpp"
+#include "../Renderer/Transform.hpp"
+#include "../Renderer/VertexFormat.hpp"
+#include "../objects/SCObject.hpp"
+#include "../parser/SCparse.hpp"
+
+#ifndef SCED_BENCH_BUILD_TYPE
+#define SCED_BENCH_BUILD_TYPE ""
+#endif
+
+using BenchClock = std::chrono::steady_clock;
+
+static const int kBatch = 1000;            // operations per sample
+static const int kRandomOps = 100000;      // per repetition, for random-access benchmarks
+static const int kQueries = 10000;         // per repetition, for spatial queries
+
+struct BenchConfig {
+    int warmup = 1;
+    int reps = 5;
+    int maxShapes = 1000000;
+    double budgetSeconds = 10.0;   // per benchmark and size
+    std::string filter;
+    std::string jsonPath;
+};
+
+struct BenchResult {
+    std::string name;
+    int shapes = 0;
+    int itemsPerOp = 1;      // shapes touched by one operation
+    std::vector<double> samples{}; // ns/op
+
+    double percentile(double p) const {
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        const double rank = p * (double)(sorted.size() - 1);
+        const size_t lo = (size_t)rank;
+        const size_t hi = std::min(lo + 1, sorted.size() - 1);
+        return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - (double)lo);
+    }
+
+    double mean() const {
+        double sum = 0.0;
+        for (double s : samples) sum += s;
+        return sum / (double)samples.size();
+    }
+};
+
+class Bench {
+public:
+    Bench(const BenchConfig& config, FILE* table) : config(config), table(table) {}
+
+    bool enabled(const char* name) const {
+        return config.filter.empty() || std::strstr(name, config.filter.c_str()) != nullptr;
+    }
+
+    // Repetitions run from start() while more(); negative ones are warmup and
+    // not recorded. Slow benchmarks stop early once past the time budget,
+    // keeping at least one measured repetition.
+    int start() {
+        started = BenchClock::now();
+        return -config.warmup;
+    }
+
+    bool more(int rep) const {
+        if (rep >= config.reps) return false;
+        if (rep <= 0) return true;
+        return std::chrono::duration<double>(BenchClock::now() - started).count() < config.budgetSeconds;
+    }
+
+    template <typename Fn>
+    static double timeNs(Fn&& fn) {
+        auto start = BenchClock::now();
+        fn();
+        auto end = BenchClock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    void record(BenchResult result) {
+        if (result.samples.empty()) return;
+        std::fprintf(table, "%-28s %9d %8zu %12.1f %12.1f %12.1f %12.1f\n", result.name.c_str(), result.shapes,
+                    result.samples.size(), result.percentile(0.5), result.percentile(0.9),
+                    result.percentile(0.99), result.mean());
+        std::fflush(table);
+        results.push_back(std::move(result));
+    }
+
+    const std::vector<BenchResult>& getResults() const { return results; }
+
+private:
+    BenchConfig config;
+    FILE* table;
+    BenchClock::time_point started;
+    std::vector<BenchResult> results;
+};
+
+static float sink = 0.0f;
+
+static const Vertex2D kTriangle[3] = {
+    { glm::vec2(0.0f, 0.0f),   glm::vec3(1, 1, 1) },
+    { glm::vec2(0.01f, 0.0f),  glm::vec3(1, 1, 1) },
+    { glm::vec2(0.0f, 0.01f),  glm::vec3(1, 1, 1) },
+};
+
+// Spread over the [-1, 1] view so culling keeps every shape
+static glm::mat4 placement(int i, int n) {
+    const int side = std::max(1, (int)std::sqrt((double)n));
+    const float step = 1.9f / (float)side;
+    return Transform::translate(Transform::setIdentity(),
+                                {-0.95f + (float)(i % side) * step, -0.95f + (float)((i / side) % side) * step});
+}
+
+static void fill(Renderer2D& renderer, std::vector<ShapeHandle>& handles, int n) {
+    handles.clear();
+    handles.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        handles.push_back(renderer.addShape(kTriangle, 3, placement(i, n)));
+    }
+}
+
+static std::vector<int> randomOrder(int count, int n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pick(0, n - 1);
+    std::vector<int> order(count);
+    for (int& o : order) o = pick(rng);
+    return order;
+}
+
+// ---------- Renderer2D ----------
+
+static void benchAddShape(Bench& bench, int n) {
+    BenchResult result{"addShape", n};
+    for (int rep = bench.start(); bench.more(rep); ++rep) {
+        Renderer2D renderer;
+        for (int done = 0; done < n; done += kBatch) {
+            const int count = std::min(kBatch, n - done);
+            const double ns = Bench::timeNs([&] {
+                for (int i = 0; i < count; ++i) renderer.addShape(kTriangle, 3, placement(done + i, n));
+            });
+            if (rep >= 0) result.samples.push_back(ns / count);
+        }
+    }
+    bench.record(std::move(result));
+}
+
+static void benchRemoveShape(Bench& bench, int n) {
+    BenchResult result{"removeShape", n};
+    std::vector<ShapeHandle> handles;
+    for (int rep = bench.start(); bench.more(rep); ++rep) {
+        Renderer2D renderer;
+        fill(renderer, handles, n);
+        std::shuffle(handles.begin(), handles.end(), std::mt19937(1234 + rep));
+
+        for (int done = 0; done < n; done += kBatch) {
+            const int count = std::min(kBatch, n - done);
+            const double ns = Bench::timeNs([&] {
+                for (int i = 0; i < count; ++i) renderer.removeShape(handles[done + i]);
+            });
+            if (rep >= 0) result.samples.push_back(ns / count);
+        }
+    }
+    bench.record(std::move(result));
+}
+
+// Random handles so the cost is not hidden by walking memory in order
+template <typename Fn>
+static void benchRandomAccess(Bench& bench, const char* name, Renderer2D& renderer,
+                              const std::vector<ShapeHandle>& handles, Fn&& op) {
+    const int n = (int)handles.size();
+    const std::vector<int> order = randomOrder(kRandomOps, n, 1234);
+
+    BenchResult result{name, n};
+    for (int rep = bench.start(); bench.more(rep); ++rep) {
+        for (int done = 0; done < kRandomOps; done += kBatch) {
+            const double ns = Bench::timeNs([&] {
+                for (int i = done; i < done + kBatch; ++i) op(renderer, handles[order[i]]);
+            });
+            if (rep >= 0) result.samples.push_back(ns / kBatch);
+        }
+    }
+    bench.record(std::move(result));
+}
+
+// Random points and boxes over the view; each query is one operation. The
+// triangles are scaled to the grid cell, so a point hits about one shape and
+// a box about the same number at every scene size.
+static void benchQueries(Bench& bench, int n) {
+    const float cell = 1.9f / (float)std::max(1, (int)std::sqrt((double)n));
+    const glm::mat4 toCell = Transform::scale(Transform::setIdentity(), glm::vec2(cell / 0.01f));
+
+    Renderer2D renderer;
+    for (int i = 0; i < n; ++i) {
+        renderer.addShape(kTriangle, 3, placement(i, n) * toCell);
+    }
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> coord(-0.95f, 0.95f);
+    std::vector<glm::vec2> points(kQueries);
+    for (glm::vec2& p : points) p = { coord(rng), coord(rng) };
+
+    // Boxes five cells across
+    const float half = 2.5f * cell;
+    std::vector<ShapeHandle> hits;
+
+    auto run = [&](const char* name, auto&& query) {
+        if (!bench.enabled(name)) return;
+
+        BenchResult result{name, n};
+        for (int rep = bench.start(); bench.more(rep); ++rep) {
+            for (int done = 0; done < kQueries; done += kBatch) {
+                const double ns = Bench::timeNs([&] {
+                    for (int i = done; i < done + kBatch; ++i) query(points[i]);
+                });
+                if (rep >= 0) result.samples.push_back(ns / kBatch);
+            }
+        }
+        bench.record(std::move(result));
+    };
+
+    run("queryPoint", [&](glm::vec2 p) {
+        hits.clear();
+        renderer.queryPoint(p, hits);
+        sink += (float)hits.size();
+    });
+
+    run("queryRect", [&](glm::vec2 p) {
+        hits.clear();
+        renderer.queryRect({ p - half, p + half }, hits);
+        sink += (float)hits.size();
+    });
+
+    run("queryNearest", [&](glm::vec2 p) {
+        sink += (float)renderer.queryNearest(p).index;
+    });
+}
+
+static void benchDrawAll(Bench& bench, Renderer2D& renderer, const Shader& shader, int n) {
+    const glm::mat4 vp = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f);
+    const int frames = 10;
+
+    // The first frame uploads the scene; only steady-state submission is timed
+    renderer.beginFrame();
+    renderer.drawAll(shader, vp);
+
+    BenchResult result{"drawAll", n, n};
+    for (int rep = bench.start(); bench.more(rep); ++rep) {
+        for (int f = 0; f < frames; ++f) {
+            const double ns = Bench::timeNs([&] {
+                renderer.beginFrame();
+                renderer.drawAll(shader, vp);
+            });
+            if (rep >= 0) result.samples.push_back(ns);
+        }
+    }
+    bench.record(std::move(result));
+}
+
+static void benchRenderer(Bench& bench, const Shader& shader, int n) {
+    if (bench.enabled("addShape")) benchAddShape(bench, n);
+    if (bench.enabled("removeShape")) benchRemoveShape(bench, n);
+
+    if (bench.enabled("queryPoint") || bench.enabled("queryRect") || bench.enabled("queryNearest")) {
+        benchQueries(bench, n);
+    }
+
+    const bool random = bench.enabled("setModel") || bench.enabled("setOverrideColor");
+    if (!random && !bench.enabled("drawAll")) return;
+
+    Renderer2D renderer;
+    std::vector<ShapeHandle> handles;
+    fill(renderer, handles, n);
+
+    if (bench.enabled("setModel")) {
+        const glm::mat4 model = Transform::translate(Transform::setIdentity(), {0.5f, 0.25f});
+        benchRandomAccess(bench, "setModel", renderer, handles, [&](Renderer2D& r, ShapeHandle h) {
+            r.setModel(h, model);
+        });
+    }
+
+    if (bench.enabled("setOverrideColor")) {
+        benchRandomAccess(bench, "setOverrideColor", renderer, handles, [](Renderer2D& r, ShapeHandle h) {
+            r.setOverrideColor(h, glm::vec3(0.5f));
+        });
+    }
+
+    if (bench.enabled("drawAll")) benchDrawAll(bench, renderer, shader, n);
+}
+
+// ---------- SCObject ----------
+
+static void benchObjectSetPosition(Bench& bench, int n) {
+    Renderer2D renderer;
+    SCObject object(&renderer);
+    for (int i = 0; i < n; ++i) {
+        object.addShape(std::vector<Vertex2D>(kTriangle, kTriangle + 3));
+    }
+
+    // One call moves every shape of the object
+    const int calls = std::clamp(100000 / n, 1, 100);
+
+    BenchResult result{"SCObject::setPosition", n, n};
+    for (int rep = bench.start(); bench.more(rep); ++rep) {
+        for (int c = 0; c < calls; ++c) {
+            const glm::vec2 position(0.001f * (float)c, -0.001f * (float)rep);
+            const double ns = Bench::timeNs([&] { object.setPosition(position); });
+            if (rep >= 0) result.samples.push_back(ns);
+        }
+    }
+    bench.record(std::move(result));
+}
+
+// ---------- Shapes ----------
+
+template <typename Fn>
+static void benchGenerator(Bench& bench, const char* name, int n, Fn&& make) {
+    BenchResult result{name, n};
+    for (int rep = bench.start(); bench.more(rep); ++rep) {
+        for (int done = 0; done < n; done += kBatch) {
+            const int count = std::min(kBatch, n - done);
+            const double ns = Bench::timeNs([&] {
+                for (int i = 0; i < count; ++i) {
+                    std::vector<Vertex2D> verts = make(done + i);
+                    sink += verts.back().pos.x;
+                }
+            });
+            if (rep >= 0) result.samples.push_back(ns / count);
+        }
+    }
+    bench.record(std::move(result));
+}
+
+static void benchShapes(Bench& bench, int n) {
+    if (bench.enabled("Shapes::makeCircle")) {
+        benchGenerator(bench, "Shapes::makeCircle", n, [](int i) {
+            return Shapes::makeCircle({0.001f * (float)(i & 1023), 0.0f}, 0.1f, 32, {1, 0.5f, 0});
+        });
+    }
+
+    if (bench.enabled("Shapes::makeEllipse")) {
+        benchGenerator(bench, "Shapes::makeEllipse", n, [](int i) {
+            return Shapes::makeEllipse({0.001f * (float)(i & 1023), 0.0f}, {0.2f, 0.1f}, 32, {0, 0.5f, 1});
+        });
+    }
+}
+
+// ---------- SCParse ----------
+
+static std::string shapeName(int i) {
+    return "shape_" + std::to_string(i);
+}
+
+// Mixed shape types, written the way hand-authored scene files are
+static void writeScene(const std::string& path, int n) {
+    std::ofstream out(path);
+    out << "{\n  \"shapes\": {\n";
+    for (int i = 0; i < n; ++i) {
+        const float x = -0.9f + 0.0017f * (float)(i % 1000);
+        const float y = -0.9f + 0.0017f * (float)((i / 1000) % 1000);
+        out << "    \"" << shapeName(i) << "\": { \"position\": [" << x << ", " << y << "], ";
+        switch (i % 4) {
+            case 0: out << "\"type\": \"circle\", \"radius\": 0.05, \"segments\": 24, "; break;
+            case 1: out << "\"type\": \"rectangle\", \"size\": { \"x\": 0.1, \"y\": 0.05 }, "; break;
+            case 2: out << "\"type\": \"ellipse\", \"radii\": [0.06, 0.03], \"segments\": 32, "; break;
+            default: out << "\"type\": \"regular_polygon\", \"radius\": 0.05, \"sides\": 6, "; break;
+        }
+        out << "\"color\": [" << (i * 37) % 256 << ", " << (i * 11) % 256 << ", 200] }"
+            << (i + 1 < n ? ",\n" : "\n");
+    }
+    out << "  }\n}\n";
+}
+
+static void benchParse(Bench& bench, int n) {
+    const bool load = bench.enabled("SCParse::setFile");
+    const bool build = bench.enabled("SCParse::getShape");
+    if (!load && !build) return;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "sced_bench_shapes.json").string();
+    writeScene(path, n);
+
+    // One sample per load, reported per shape
+    if (load) {
+        BenchResult result{"SCParse::setFile", n};
+        for (int rep = bench.start(); bench.more(rep); ++rep) {
+            const double ns = Bench::timeNs([&] { SCParse::setFile(path); });
+            if (rep >= 0) result.samples.push_back(ns / n);
+        }
+        bench.record(std::move(result));
+    }
+
+    if (build) {
+        if (!load) SCParse::setFile(path);
+
+        std::vector<std::string> names(n);
+        for (int i = 0; i < n; ++i) names[i] = shapeName(i);
+
+        BenchResult result{"SCParse::getShape", n};
+        for (int rep = bench.start(); bench.more(rep); ++rep) {
+            for (int done = 0; done < n; done += kBatch) {
+                const int count = std::min(kBatch, n - done);
+                const double ns = Bench::timeNs([&] {
+                    for (int i = 0; i < count; ++i) {
+                        sink += SCParse::getShape(names[done + i])->generateVertices().size();
+                    }
+                });
+                if (rep >= 0) result.samples.push_back(ns / count);
+            }
+        }
+        bench.record(std::move(result));
+    }
+
+    std::filesystem::remove(path);
+}
+
+// ---------- Output ----------
+
+static const char* vertexFormatName() {
+#if defined(SCED_VERTEX_FORMAT_FULL)
+    return "Full";
+#elif defined(SCED_VERTEX_FORMAT_HALF)
+    return "Half";
+#elif defined(SCED_VERTEX_FORMAT_POSITIONONLY)
+    return "PositionOnly";
+#else
+    return "Packed";
+#endif
+}
+
+static nlohmann::ordered_json toJson(const BenchConfig& config, const std::vector<BenchResult>& results) {
+    char timestamp[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    nlohmann::ordered_json doc;
+    doc["suite"] = "sced_bench";
+    doc["timestamp"] = timestamp;
+    doc["build"] = {
+        {"type", SCED_BENCH_BUILD_TYPE},
+        {"vertexFormat", vertexFormatName()},
+        {"gpuVertexBytes", sizeof(GpuVertex)},
+#ifdef __VERSION__
+        {"compiler", __VERSION__},
+#endif
+    };
+    doc["config"] = {
+        {"warmup", config.warmup},
+        {"reps", config.reps},
+        {"batch", kBatch},
+        {"budgetSeconds", config.budgetSeconds},
+        {"backend", "null"},
+    };
+
+    nlohmann::ordered_json list = nlohmann::ordered_json::array();
+    for (const BenchResult& r : results) {
+        const double p50 = r.percentile(0.5);
+        list.push_back({
+            {"name", r.name},
+            {"shapes", r.shapes},
+            {"itemsPerOp", r.itemsPerOp},
+            {"unit", "ns/op"},
+            {"samples", r.samples.size()},
+            {"min", r.percentile(0.0)},
+            {"p50", p50},
+            {"p90", r.percentile(0.9)},
+            {"p99", r.percentile(0.99)},
+            {"max", r.percentile(1.0)},
+            {"mean", r.mean()},
+            {"opsPerSecond", p50 > 0.0 ? 1e9 / p50 : 0.0},
+        });
+    }
+    doc["results"] = list;
+    return doc;
+}
+
+static bool parseArgs(int argc, char** argv, BenchConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--json") == 0 && hasValue) {
+            config.jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--max-shapes") == 0 && hasValue) {
+            config.maxShapes = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--reps") == 0 && hasValue) {
+            config.reps = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue) {
+            config.warmup = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--budget") == 0 && hasValue) {
+            config.budgetSeconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--filter") == 0 && hasValue) {
+            config.filter = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [--json path|-] [--max-shapes N] [--reps N] [--warmup N] "
+                                 "[--budget seconds] [--filter text]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) return 2;
+
+    if (!RenderBackend::load(BackendKind::Null)) return -1;
+
+    // With --json - the table goes to stderr so stdout stays parseable
+    FILE* table = config.jsonPath == "-" ? stderr : stdout;
+    Bench bench(config, table);
+    Shader shader = Shader::fromFiles("Shader/config/flat.vert", "Shader/config/flat.frag");
+
+    std::fprintf(table, "%-28s %9s %8s %12s %12s %12s %12s\n", "benchmark", "shapes", "samples", "p50 ns/op",
+                 "p90 ns/op", "p99 ns/op", "mean ns/op");
+
+    const int sizes[] = { 1000, 10000, 100000, 1000000 };
+    for (int n : sizes) {
+        if (n > config.maxShapes) break;
+
+        benchRenderer(bench, shader, n);
+        if (bench.enabled("SCObject::setPosition")) benchObjectSetPosition(bench, n);
+        benchShapes(bench, n);
+        benchParse(bench, n);
+    }
+
+    if (sink < 0.0f) std::printf("%f\n", sink);
+
+    if (!config.jsonPath.empty()) {
+        const std::string text = toJson(config, bench.getResults()).dump(2);
+        if (config.jsonPath == "-") {
+            std::printf("%s\n", text.c_str());
+        } else {
+            std::ofstream out(config.jsonPath);
+            out << text << '\n';
+            if (!out) {
+                std::fprintf(stderr, "cannot write %s\n", config.jsonPath.c_str());
+                return 1;
+            }
+            std::fprintf(table, "results written to %s\n", config.jsonPath.c_str());
+        }
+    }
+
+    RenderBackend::release();
+    return 0;
+}
@@ -0,0 +1,144 @@
+// ShapeHandle_Bench.cpp
+// Times per-handle Renderer2D operations as the scene grows from 1k to 1M
+// shapes and fails if setModel stops being flat: its in-order cost may grow
+// from the smallest to the largest scene by at most twice as much as a bare
+// in-order getRecord read over the same records.
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../Renderer/Renderer2D.hpp"
+#include "../core/Window.h"
+#include "../Renderer/Transform.hpp"
+#include "../Renderer/Vertex2D.hpp"
+
+using BenchClock = std::chrono::steady_clock;
+
+template <typename Fn>
+static double nsPerOp(int ops, Fn&& fn) {
+    auto start = BenchClock::now();
+    for (int i = 0; i < ops; ++i) fn(i);
+    auto end = BenchClock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / ops;
+}
+
+int main() {
+    // SCED_HEADLESS=1 runs without a display
+    const WindowMode mode = Window::modeFromEnvironment();
+    if (!Window::initGlfw(mode)) return -1;
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow* window = Window::createNative(64, 64, "ShapeHandle Bench", mode);
+    if (!window) return -1;
+
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) return -1;
+
+    const Vertex2D tri[3] = {
+        { glm::vec2(0.0f, 0.0f), glm::vec3(1, 1, 1) },
+        { glm::vec2(0.1f, 0.0f), glm::vec3(1, 1, 1) },
+        { glm::vec2(0.0f, 0.1f), glm::vec3(1, 1, 1) },
+    };
+
+    const int ops = 1000000;
+    const int sizes[] = { 1000, 10000, 100000, 1000000 };
+    const double flatnessBound = 2.0;
+
+    std::printf("%10s %18s %18s %16s %19s %16s %14s\n", "shapes", "getRecord in-order", "setModel in-order",
+                "setModel random", "overrideColor random", "getRecord random", "flush/shape");
+
+    double firstRead = 0.0, firstSetModel = 0.0;
+    double lastRead = 0.0, lastSetModel = 0.0;
+
+    for (int n : sizes) {
+        Renderer2D renderer;
+        std::vector<ShapeHandle> handles;
+        handles.reserve(n);
+
+        for (int i = 0; i < n; ++i) {
+            handles.push_back(renderer.addShape(tri, 3));
+        }
+
+        // Random access so the cost is not hidden by walking memory in order
+        std::mt19937 rng(1234);
+        std::uniform_int_distribution<int> pick(0, n - 1);
+        std::vector<int> order(ops);
+        for (int& o : order) o = pick(rng);
+
+        glm::mat4 model = Transform::translate(Transform::setIdentity(), {0.5f, 0.25f});
+        float sink = 0.0f;
+
+        // Same records, same order, nothing but the lookup: the memory floor
+        double readNs = nsPerOp(ops, [&](int i) {
+            sink += renderer.getRecord(handles[i % n])->model[3][0];
+        });
+
+        // Flushed after every pass over the scene so each call marks a clean
+        // shape, at 1k as at 1M; only the setModel calls are timed. The first
+        // flush is where bounds and the spatial index catch up with the move.
+        double inOrderNs = 0.0, flushNs = 0.0;
+        for (int done = 0; done < ops; done += n) {
+            const int pass = std::min(n, ops - done);
+            inOrderNs += nsPerOp(pass, [&](int i) {
+                renderer.setModel(handles[i], model);
+            }) * pass;
+
+            const double flush = nsPerOp(1, [&](int) { renderer.flushBounds(); });
+            if (done == 0) flushNs = flush / pass;
+        }
+        inOrderNs /= ops;
+
+        double setModelNs = nsPerOp(ops, [&](int i) {
+            renderer.setModel(handles[order[i]], model);
+        });
+
+        double overrideNs = nsPerOp(ops, [&](int i) {
+            renderer.setOverrideColor(handles[order[i]], glm::vec3(0.5f));
+        });
+
+        double getRecordNs = nsPerOp(ops, [&](int i) {
+            sink += renderer.getRecord(handles[order[i]])->model[3][0];
+        });
+
+        std::printf("%10d %18.2f %18.2f %16.2f %19.2f %16.2f %14.2f\n", n, readNs, inOrderNs, setModelNs,
+                    overrideNs, getRecordNs, flushNs);
+
+        if (firstRead == 0.0) {
+            firstRead = readNs;
+            firstSetModel = inOrderNs;
+        }
+        lastRead = readNs;
+        lastSetModel = inOrderNs;
+
+        if (sink < 0.0f) std::printf("%f\n", sink);
+    }
+
+    // Stale handles are reported rather than silently hitting another shape
+    bool staleRejected = false;
+    {
+        Renderer2D renderer;
+        ShapeHandle stale = renderer.addShape(tri, 3);
+        renderer.removeShape(stale);
+        ShapeHandle reused = renderer.addShape(tri, 3);
+
+        staleRejected = !renderer.setModel(stale, glm::mat4(1.0f)) && renderer.isValid(reused);
+    }
+    std::printf("stale handle rejected: %s\n", staleRejected ? "yes" : "NO");
+
+    const double readGrowth = lastRead / firstRead;
+    const double setModelGrowth = lastSetModel / firstSetModel;
+    const bool flat = setModelGrowth <= flatnessBound * readGrowth;
+    std::printf("setModel in-order grew %.2fx from %d to %d shapes, getRecord %.2fx; "
+                "allowed %.2fx (%.1fx getRecord's): %s\n",
+                setModelGrowth, sizes[0], sizes[3], readGrowth, flatnessBound * readGrowth, flatnessBound,
+                flat ? "flat" : "NOT FLAT");
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return staleRejected && flat ? 0 : 1;
+}
@@ -16,6 +16,8 @@
 #include "../objects/SCObject.hpp"
 #include "../ui/elements/SCButton.hpp"
 #include "../input/Input.h"
+#include "../core/FixedTimestep.h"
+#include "../core/Profiler.h"
 #include "../color/SColor.hpp"
 
 double backgroundFlashTimer = 0.0;
@@ -141,10 +143,17 @@ int main() {
 
     int points = 0;
 
+    // Timers advance in whole 60 Hz steps of real time, not per frame
+    FixedTimestep timestep(60.0, 8);
+    double lastTime = glfwGetTime();
+
     // -------------------------------------------------------------
     // MAIN LOOP
     while(!glfwWindowShouldClose(window)) {
         glfwPollEvents();
+        Profiler::beginFrame();
+        Profiler::collectGpuTimings();
+        renderer.beginFrame();
         glfwGetFramebufferSize(window,&width,&height);
         if(height==0) height=1;
         float aspect = float(width)/float(height);
@@ -153,6 +162,10 @@ int main() {
         glClearColor(0.08f,0.08f,0.1f,1.f);
         glClear(GL_COLOR_BUFFER_BIT);
 
+        double now = glfwGetTime();
+        const double elapsed = timestep.advance(now - lastTime) * timestep.step();
+        lastTime = now;
+
         FrameState fs = fsUpdate(input, window, width, height, aspect);
         fs.mouseJustPressed = (fs.mouseDown && !mouseWasDown);
 
@@ -166,7 +179,7 @@ int main() {
         bool correct = false;
 
         if(state == GameState::ShowSequence) {
-            timer -= 1.0/60.0;
+            timer -= elapsed;
 
             if(!flashing) {
                 // reset all pad colors
@@ -240,7 +253,7 @@ int main() {
         }
 
         if (state == GameState::DelayBeforeShow) {
-            delayTimer -= 1.0 / 60.0;
+            delayTimer -= elapsed;
             if (delayTimer <= 0.0) {
                 state = GameState::ShowSequence;
                 timer = pauseTime;
@@ -256,7 +269,7 @@ int main() {
         
         if (backgroundIsFlashing) {
         background.setShapeColor(backgroundHandle, backgroundFlashColor);
-        backgroundFlashTimer -= 1.0/60.0;
+        backgroundFlashTimer -= elapsed;
 
             if (backgroundFlashTimer <= 0.0) {
                 backgroundIsFlashing = false;
@@ -0,0 +1,162 @@
+// Software_Raster.cpp
+// Draws one scene with the GPU into an OffscreenTarget and with
+// SoftwareRasterizer, then diffs the images. Tessellated shapes, indexed
+// meshes, instances, override colors, draw order and SDF primitives are all
+// covered. The CPU image must match itself across thread counts exactly and
+// the GPU image everywhere but a thin band of edge pixels.
+// Runs headless; pass a path to also save the CPU frame as PPM.
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../Renderer/OffscreenTarget.hpp"
+#include "../Renderer/Renderer2D.hpp"
+#include "../Renderer/SoftwareRasterizer.hpp"
+#include "../Renderer/Shader/Shader.hpp"
+#include "../Renderer/Shapes.hpp"
+#include "../Renderer/Transform.hpp"
+#include "../core/Window.h"
+
+static const int kWidth = 320;
+static const int kHeight = 240;
+
+static void buildScene(Renderer2D& renderer) {
+    // Background band behind everything
+    auto band = Shapes::makeRectangle({-2.0f, -0.2f}, {2.0f, 0.2f}, {0.2f, 0.3f, 0.8f});
+    ShapeHandle back = renderer.addShape(band.data(), (int)band.size());
+    renderer.sendToBack(back);
+
+    // Gradient triangle, drawn with per-vertex colors
+    const Vertex2D tri[3] = {
+        { glm::vec2(-1.2f, -0.9f), glm::vec3(1, 0, 0) },
+        { glm::vec2(-0.3f, -0.9f), glm::vec3(0, 1, 0) },
+        { glm::vec2(-0.75f, 0.8f), glm::vec3(0, 0, 1) },
+    };
+    renderer.addShape(tri, 3);
+
+    // Rotated indexed circle with an override color
+    ShapeHandle disc = renderer.addShape(Shapes::makeCircleMesh({0.0f, 0.0f}, 0.35f, 48, {1, 1, 1}),
+                                         Transform::translate(Transform::setIdentity(), {0.2f, 0.45f}));
+    renderer.setOverrideColor(disc, {1.0f, 0.6f, 0.1f});
+
+    // Instances of one shared mesh
+    MeshHandle square = renderer.addMesh(Shapes::makeRectangleMesh({-0.1f, -0.1f}, {0.1f, 0.1f}, {1, 1, 1}));
+    for (int i = 0; i < 5; ++i) {
+        glm::mat4 model = Transform::translate(Transform::setIdentity(), {-0.2f + i * 0.25f, -0.6f});
+        model = Transform::rotateZ(model, 0.3f * i);
+        renderer.addInstance(square, model, glm::vec3(0.1f * i, 0.9f, 0.5f));
+    }
+    renderer.releaseMesh(square);
+
+    // Analytic primitives on top
+    SdfPrimitive ellipse;
+    ellipse.kind = SdfKind::Ellipse;
+    ellipse.halfSize = {0.3f, 0.2f};
+    renderer.addPrimitive(ellipse, Transform::translate(Transform::setIdentity(), {0.9f, 0.3f}), {0.9f, 0.2f, 0.6f});
+
+    SdfPrimitive box;
+    box.kind = SdfKind::RoundedRect;
+    box.halfSize = {0.25f, 0.15f};
+    box.cornerRadius = 0.06f;
+    renderer.addPrimitive(box, Transform::translate(Transform::setIdentity(), {0.9f, -0.4f}), {0.3f, 0.9f, 0.9f});
+
+    // Off screen: culled by both renderers
+    auto far = Shapes::makeRectangle({5.0f, 5.0f}, {6.0f, 6.0f}, {1, 1, 1});
+    renderer.addShape(far.data(), (int)far.size());
+}
+
+static int differs(const uint8_t* a, const uint8_t* b) {
+    return std::abs(a[0] - b[0]) > 2 || std::abs(a[1] - b[1]) > 2 || std::abs(a[2] - b[2]) > 2;
+}
+
+int main(int argc, char** argv) {
+    if (!Window::initGlfw(WindowMode::Headless)) return -1;
+
+    GLFWwindow* window = Window::createNative(kWidth, kHeight, "Software Raster", WindowMode::Headless);
+    if (!window) return -1;
+
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) return -1;
+
+    int failures = 0;
+    {
+        Renderer2D renderer;
+        Shader shader = Shader::fromFiles("Shader/config/flat.vert", "Shader/config/flat.frag");
+        buildScene(renderer);
+
+        const float aspect = (float)kWidth / (float)kHeight;
+        const glm::mat4 vp = glm::ortho(-aspect, aspect, -1.0f, 1.0f, -1.0f, 1.0f);
+        const glm::vec4 background(0.1f, 0.1f, 0.12f, 1.0f);
+
+        // GPU reference
+        OffscreenTarget target(kWidth, kHeight);
+        target.bind();
+        glClearColor(background.r, background.g, background.b, background.a);
+        glClear(GL_COLOR_BUFFER_BIT);
+        renderer.drawAll(shader, vp);
+
+        std::vector<uint8_t> gpu;
+        target.readPixels(gpu);
+
+        // CPU, one thread and then all of them
+        SoftwareRasterizer raster(kWidth, kHeight, 1);
+        raster.clear(background);
+        raster.draw(renderer, vp);
+
+        std::vector<uint8_t> single;
+        raster.readPixels(single);
+        const SoftwareRasterStats singleStats = raster.getStats();
+
+        raster.setThreads(0);
+        raster.clear(background);
+        raster.draw(renderer, vp);
+
+        std::vector<uint8_t> threaded;
+        raster.readPixels(threaded);
+        const SoftwareRasterStats stats = raster.getStats();
+
+        std::printf("%u shapes (%u culled), %u triangles in %u tile bins\n",
+                    stats.shapesDrawn, stats.shapesCulled, stats.triangles, stats.binnedTriangles);
+        std::printf("1 thread: %.3f ms, %u threads: %.3f ms (setup %.3f ms), %d pixels per step\n",
+                    singleStats.setupMilliseconds + singleStats.rasterMilliseconds, stats.threads,
+                    stats.setupMilliseconds + stats.rasterMilliseconds, stats.setupMilliseconds,
+                    SoftwareRasterizer::simdWidth());
+
+        if (single != threaded) {
+            std::printf("  thread count changed the image\n");
+            ++failures;
+        }
+
+        if (stats.shapesCulled != 1) {
+            std::printf("  expected 1 culled shape, got %u\n", stats.shapesCulled);
+            ++failures;
+        }
+
+        // Only edge pixels may disagree with the GPU
+        int mismatched = 0;
+        for (size_t i = 0; i < gpu.size(); i += 4) {
+            mismatched += differs(&gpu[i], &threaded[i]);
+        }
+
+        const double fraction = (double)mismatched / (kWidth * kHeight);
+        std::printf("GPU vs CPU: %d of %d pixels differ (%.3f%%)\n", mismatched, kWidth * kHeight, fraction * 100.0);
+        if (fraction > 0.005) {
+            ++failures;
+        }
+
+        if (argc > 1 && raster.savePpm(argv[1])) {
+            std::printf("frame written to %s\n", argv[1]);
+        }
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+
+    std::printf("software raster: %s (%d failures)\n", failures == 0 ? "ok" : "FAILED", failures);
+    return failures == 0 ? 0 : 1;
+}
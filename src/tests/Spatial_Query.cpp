@@ -0,0 +1,214 @@
+// Spatial_Query.cpp
+// Checks Renderer2D's spatial queries against a brute-force scan on a
+// 100k-shape scene: random sizes, rotations and scales, with part of the
+// scene removed and part moved again after the tree was built (so the
+// lazily flushed bounds are exercised too). Every queryPoint/queryRect must
+// return exactly the shapes whose world box matches, and queryNearest a
+// shape at the brute-force minimum distance. Also covers a clone taken
+// while its source has a pending move.
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../Renderer/Renderer2D.hpp"
+#include "../Renderer/SpatialIndex.hpp"
+#include "../core/Window.h"
+#include "../Renderer/Transform.hpp"
+#include "../Renderer/Vertex2D.hpp"
+
+using QueryClock = std::chrono::steady_clock;
+
+struct Expected {
+    ShapeHandle handle;
+    Aabb2D bounds;      // computed here from the vertices and model, not read back
+    bool alive;
+};
+
+static double msSince(QueryClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(QueryClock::now() - start).count();
+}
+
+static bool sameHandles(std::vector<ShapeHandle> a, std::vector<ShapeHandle> b) {
+    auto byKey = [](ShapeHandle x, ShapeHandle y) { return x.key() < y.key(); };
+    std::sort(a.begin(), a.end(), byKey);
+    std::sort(b.begin(), b.end(), byKey);
+    return a == b;
+}
+
+int main() {
+    // SCED_HEADLESS=1 runs without a display
+    const WindowMode mode = Window::modeFromEnvironment();
+    if (!Window::initGlfw(mode)) return -1;
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow* window = Window::createNative(64, 64, "Spatial Query", mode);
+    if (!window) return -1;
+
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) return -1;
+
+    const int shapeCount = 100000;
+    const int queries = 500;
+    const float world = 1000.0f;
+
+    int failures = 0;
+    {
+        Renderer2D renderer;
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> position(0.0f, world);
+        std::uniform_real_distribution<float> size(0.05f, 4.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        auto randomModel = [&] {
+            glm::mat4 m = Transform::translate(Transform::setIdentity(), {position(rng), position(rng)});
+            m = Transform::rotateZ(m, angle(rng));
+            return Transform::scale(m, {0.5f + unit(rng), 0.5f + unit(rng)});
+        };
+
+        std::vector<Expected> expected;
+        expected.reserve(shapeCount);
+
+        for (int i = 0; i < shapeCount; ++i) {
+            const float w = size(rng), h = size(rng);
+            const Vertex2D tri[3] = {
+                { glm::vec2(-w, -h), glm::vec3(1, 1, 1) },
+                { glm::vec2( w, -h), glm::vec3(1, 1, 1) },
+                { glm::vec2(0.0f, h), glm::vec3(1, 1, 1) },
+            };
+
+            const glm::mat4 model = randomModel();
+            ShapeHandle handle = renderer.addShape(tri, 3, model);
+            expected.push_back({ handle, Aabb2D::of(tri, 3).transformed(model), true });
+        }
+
+        // Churn after the tree exists: remove a tenth, move a fifth
+        std::uniform_int_distribution<int> pick(0, shapeCount - 1);
+        for (int i = 0; i < shapeCount / 10; ++i) {
+            Expected& e = expected[pick(rng)];
+            if (e.alive && renderer.removeShape(e.handle)) e.alive = false;
+        }
+
+        for (int i = 0; i < shapeCount / 5; ++i) {
+            Expected& e = expected[pick(rng)];
+            if (!e.alive) continue;
+
+            const ShapeRecord* r = renderer.getRecord(e.handle);
+            const glm::mat4 model = randomModel();
+            e.bounds = r->localBounds.transformed(model);
+            renderer.setModel(e.handle, model);
+        }
+
+        // The first query flushes the moves above; keep that out of the timings
+        renderer.queryNearest(glm::vec2(0.0f));
+
+        double treeMs = 0.0, bruteMs = 0.0;
+        std::vector<ShapeHandle> got, want;
+
+        for (int q = 0; q < queries; ++q) {
+            const glm::vec2 p(position(rng), position(rng));
+            const glm::vec2 extent(size(rng) * 10.0f, size(rng) * 10.0f);
+            const Aabb2D box{ p - extent, p + extent };
+
+            // Point
+            got.clear();
+            auto start = QueryClock::now();
+            renderer.queryPoint(p, got);
+            treeMs += msSince(start);
+
+            want.clear();
+            start = QueryClock::now();
+            for (const Expected& e : expected) {
+                const Aabb2D& b = e.bounds;
+                if (e.alive && p.x >= b.min.x && p.x <= b.max.x && p.y >= b.min.y && p.y <= b.max.y) {
+                    want.push_back(e.handle);
+                }
+            }
+            bruteMs += msSince(start);
+
+            if (!sameHandles(got, want)) {
+                std::printf("  queryPoint (%.2f, %.2f): %zu shapes, brute force %zu\n", p.x, p.y, got.size(), want.size());
+                ++failures;
+            }
+
+            // Rect
+            got.clear();
+            start = QueryClock::now();
+            renderer.queryRect(box, got);
+            treeMs += msSince(start);
+
+            want.clear();
+            start = QueryClock::now();
+            for (const Expected& e : expected) {
+                if (e.alive && e.bounds.intersects(box)) want.push_back(e.handle);
+            }
+            bruteMs += msSince(start);
+
+            if (!sameHandles(got, want)) {
+                std::printf("  queryRect around (%.2f, %.2f): %zu shapes, brute force %zu\n", p.x, p.y, got.size(), want.size());
+                ++failures;
+            }
+
+            // Nearest; ties may pick any of the closest shapes
+            start = QueryClock::now();
+            ShapeHandle nearest = renderer.queryNearest(p);
+            treeMs += msSince(start);
+
+            float best = FLT_MAX;
+            start = QueryClock::now();
+            for (const Expected& e : expected) {
+                if (e.alive) best = std::min(best, SpatialIndex::distance(e.bounds, p));
+            }
+            bruteMs += msSince(start);
+
+            const ShapeRecord* r = renderer.getRecord(nearest);
+            if (!r || SpatialIndex::distance(r->bounds, p) != best) {
+                std::printf("  queryNearest (%.2f, %.2f): distance %f, brute force %f\n", p.x, p.y,
+                            r ? SpatialIndex::distance(r->bounds, p) : -1.0f, best);
+                ++failures;
+            }
+        }
+
+        std::printf("%zu shapes, %d point/rect/nearest queries: tree %.1f ms, brute force %.1f ms\n",
+                    renderer.shapeCount(), queries, treeMs, bruteMs);
+    }
+
+    // A clone made while its source still has an unflushed setModel must not
+    // inherit the pending mark, or its own moves are never flushed
+    {
+        Renderer2D renderer;
+        const Vertex2D tri[3] = {
+            { glm::vec2(-0.5f, -0.5f), glm::vec3(1, 1, 1) },
+            { glm::vec2( 0.5f, -0.5f), glm::vec3(1, 1, 1) },
+            { glm::vec2( 0.0f,  0.5f), glm::vec3(1, 1, 1) },
+        };
+
+        ShapeHandle source = renderer.addShape(tri, 3, Transform::setIdentity());
+        renderer.setModel(source, Transform::translate(Transform::setIdentity(), {5.0f, 5.0f}));
+        ShapeHandle clone = renderer.cloneShape(source, Transform::setIdentity());
+        renderer.flushBounds();
+
+        renderer.setModel(clone, Transform::translate(Transform::setIdentity(), {20.0f, 20.0f}));
+        renderer.flushBounds();
+
+        std::vector<ShapeHandle> got;
+        renderer.queryPoint(glm::vec2(20.2f, 20.2f), got);
+        const ShapeRecord* r = renderer.getRecord(clone);
+        if (got.size() != 1 || got[0] != clone || r->boundsStale || r->bounds.min.x < 19.0f) {
+            std::printf("  clone after unflushed setModel: %zu shapes at (20.2, 20.2), bounds min (%.2f, %.2f)\n",
+                        got.size(), r->bounds.min.x, r->bounds.min.y);
+            ++failures;
+        }
+    }
+
+    std::printf("spatial query: %s (%d failures)\n", failures == 0 ? "ok" : "FAILED", failures);
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return failures == 0 ? 0 : 1;
+}
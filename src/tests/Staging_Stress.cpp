@@ -0,0 +1,200 @@
+// Staging_Stress.cpp
+// Many producer threads stage shapes and model updates through
+// StagingQueue writers while the render thread keeps committing frames and
+// adding/removing shapes of its own. Producers wait for a frame after some
+// of their publishes, so commits interleave with production even on one
+// core. Afterwards every staged shape must exist exactly once with the
+// vertices, indices, color tag and final model it was given.
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "../Renderer/Renderer2D.hpp"
+#include "../core/Window.h"
+#include "../Renderer/Transform.hpp"
+#include "../Renderer/Vertex2D.hpp"
+
+using StressClock = std::chrono::steady_clock;
+
+// Color and model encode (thread, shape) so the commit can be checked. One
+// byte per channel, so the tag survives 8-bit vertex colors.
+static glm::vec3 tag(int thread, int shape) {
+    return glm::vec3((float)(thread & 0xFF), (float)(shape & 0xFF), (float)((shape >> 8) & 0xFF)) / 255.0f;
+}
+
+static bool hasTag(const glm::vec3& color, int thread, int shape) {
+    return glm::ivec3(glm::round(color * 255.0f)) == glm::ivec3(glm::round(tag(thread, shape) * 255.0f));
+}
+
+static glm::mat4 placement(int thread, int shape, int version) {
+    return Transform::translate(Transform::setIdentity(), {(float)thread, (float)(shape * 4 + version)});
+}
+
+int main() {
+    // SCED_HEADLESS=1 runs without a display
+    const WindowMode mode = Window::modeFromEnvironment();
+    if (!Window::initGlfw(mode)) return -1;
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow* window = Window::createNative(64, 64, "Staging Stress", mode);
+    if (!window) return -1;
+
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) return -1;
+
+    const int producers = (int)std::max(8u, std::thread::hardware_concurrency());
+    const int perProducer = 20000;
+    const int minOverlapped = 16;   // frames that must commit while producers run
+
+    // Scoped so the renderer releases its GL objects before the context goes
+    int failures = 0;
+    {
+        Renderer2D renderer;
+        std::vector<std::vector<ShapeHandle>> staged(producers);
+        std::atomic<int> running{producers};
+        std::atomic<int> framesDone{0};
+
+        auto start = StressClock::now();
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < producers; ++t) {
+            threads.emplace_back([&, t] {
+                StagingQueue::Writer writer(renderer.staging());
+                std::mt19937 rng(t);
+                std::vector<ShapeHandle>& handles = staged[t];
+                handles.reserve(perProducer);
+
+                for (int i = 0; i < perProducer; ++i) {
+                    const glm::vec3 color = tag(t, i);
+
+                    // Alternate plain triangles and indexed quads
+                    if (i % 2 == 0) {
+                        const Vertex2D tri[3] = {
+                            { glm::vec2(0.0f, 0.0f), color },
+                            { glm::vec2(1.0f, 0.0f), color },
+                            { glm::vec2(0.0f, 1.0f), color },
+                        };
+                        handles.push_back(writer.addShape(tri, 3, placement(t, i, 0)));
+                    } else {
+                        Mesh2D quad;
+                        quad.vertices = {
+                            { glm::vec2(0.0f, 0.0f), color }, { glm::vec2(1.0f, 0.0f), color },
+                            { glm::vec2(1.0f, 1.0f), color }, { glm::vec2(0.0f, 1.0f), color },
+                        };
+                        quad.indices = { 0, 1, 2, 0, 2, 3 };
+                        handles.push_back(writer.addShape(quad, placement(t, i, 0)));
+                    }
+
+                    // Move some shapes after staging them, sometimes from a later block
+                    if (i % 7 == 0) {
+                        writer.setModel(handles.back(), placement(t, i, 1));
+                    }
+                    if (i % 11 == 0 && i >= 11) {
+                        writer.setModel(handles[i - 11], placement(t, i - 11, 2));
+                    }
+
+                    // Publish at odd points and wait for the render thread to
+                    // get through a frame before going on
+                    if (rng() % 500 == 0) {
+                        writer.flush();
+
+                        const int frame = framesDone.load();
+                        while (framesDone.load() == frame) std::this_thread::yield();
+                    }
+                }
+
+                writer.flush();
+                running.fetch_sub(1);
+            });
+        }
+
+        // Render thread: commit while the producers run, with its own churn
+        // competing for slots
+        const Vertex2D own[3] = {
+            { glm::vec2(0.0f, 0.0f), glm::vec3(-1.0f) },
+            { glm::vec2(1.0f, 0.0f), glm::vec3(-1.0f) },
+            { glm::vec2(0.0f, 1.0f), glm::vec3(-1.0f) },
+        };
+        std::vector<ShapeHandle> mine;
+        int frames = 0, overlapped = 0;
+        uint32_t committed = 0;
+
+        while (running.load() > 0) {
+            renderer.beginFrame();
+            const uint32_t staged = renderer.getStats().shapesStaged;
+            committed += staged;
+            if (staged > 0) ++overlapped;
+            ++frames;
+            framesDone.fetch_add(1);
+
+            for (int i = 0; i < 50; ++i) mine.push_back(renderer.addShape(own, 3));
+            for (int i = 0; i < 25 && !mine.empty(); ++i) {
+                renderer.removeShape(mine.front());
+                mine.erase(mine.begin());
+            }
+        }
+
+        for (std::thread& thread : threads) thread.join();
+
+        renderer.beginFrame();
+        committed += renderer.getStats().shapesStaged;
+
+        double ms = std::chrono::duration<double, std::milli>(StressClock::now() - start).count();
+
+        // Check every staged shape
+        std::unordered_set<uint32_t> seen;
+
+        for (int t = 0; t < producers; ++t) {
+            for (int i = 0; i < perProducer; ++i) {
+                ShapeHandle h = staged[t][i];
+                const ShapeRecord* r = renderer.getRecord(h);
+
+                if (!r || !seen.insert(h.index).second) {
+                    ++failures;
+                    continue;
+                }
+
+                int version = 0;
+                if (i % 7 == 0) version = 1;
+                if (i % 11 == 0 && i + 11 < perProducer) version = 2;
+
+                Mesh2D mesh = renderer.getMesh(h);
+                const bool shapeOk = (int)mesh.vertices.size() == (i % 2 == 0 ? 3 : 4) &&
+                                     (int)mesh.indices.size() == (i % 2 == 0 ? 3 : 6) &&
+                                     mesh.vertices[1].pos == glm::vec2(1.0f, 0.0f) &&
+                                     hasTag(mesh.vertices[0].color, t, i) &&
+                                     r->model == placement(t, i, version);
+
+                if (!shapeOk) ++failures;
+            }
+        }
+
+        for (ShapeHandle h : mine) {
+            if (!renderer.isValid(h) || !seen.insert(h.index).second) ++failures;
+        }
+
+        const size_t expected = (size_t)producers * perProducer + mine.size();
+        if (renderer.shapeCount() != expected || committed != (uint32_t)producers * perProducer) ++failures;
+
+        if (overlapped < minOverlapped) {
+            std::printf("  only %d frames committed while producers ran (want %d)\n", overlapped, minOverlapped);
+            ++failures;
+        }
+
+        std::printf("%d producers x %d shapes, %d frames (%d committing during production), %.1f ms, %u committed\n",
+                    producers, perProducer, frames, overlapped, ms, committed);
+        std::printf("staging stress: %s (%d failures)\n", failures == 0 ? "ok" : "FAILED", failures);
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return failures == 0 ? 0 : 1;
+}
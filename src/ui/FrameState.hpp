@@ -12,11 +12,10 @@ struct FrameState {
     bool overButton;
 };
 
-inline FrameState updateFrameInput(class Input& input, GLFWwindow* window,
-                                   int width, int height, float aspect, bool mouseWasDown) {
+inline FrameState updateFrameInput(class Input& input, int width, int height, float aspect, bool mouseWasDown) {
     FrameState fi{};
     fi.worldPos = screenToWorld(input.getMouseX(), input.getMouseY(), width, height, aspect);
-    fi.mouseDown = (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS);
+    fi.mouseDown = input.isMouseButtonPressed(GLFW_MOUSE_BUTTON_LEFT);
     fi.mouseJustPressed = (fi.mouseDown && !mouseWasDown);
     return fi;
 }
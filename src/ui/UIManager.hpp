@@ -1,18 +1,38 @@
 #pragma once
+#include <unordered_map>
 #include <vector>
 #include "elements/SCButton.hpp"
 #include "FrameState.hpp"
+#include "../core/Profiler.h"
 
 class UIManager {
 public:
-    void addButton(SCButton* btn) { buttons.push_back(btn); }
+    // Hit tests go through the renderer's spatial index, so the cost is the
+    // shapes under the cursor rather than every button
+    explicit UIManager(Renderer2D* renderer) : renderer(renderer) {}
+
+    void addButton(SCButton* btn) {
+        buttons.push_back(btn);
+        byShape[btn->getHandle().key()] = btn;
+    }
 
     void updateAll(const FrameState& fi, bool prevMouseDown) {
-        for (auto* b : buttons) b->update(fi, prevMouseDown);
+        SCED_PROFILE_SCOPE("UIManager::updateAll");
+
+        hits.clear();
+        renderer->queryPoint(fi.worldPos, hits);
+
+        for (auto& h : hits) {
+            auto it = byShape.find(h.key());
+            if (it != byShape.end()) it->second->update(fi, prevMouseDown);
+        }
     }
 
     bool anyContains(const glm::vec2& worldPos) const {
-        for (auto* b : buttons) if (b->contains(worldPos)) return true;
+        hits.clear();
+        renderer->queryPoint(worldPos, hits);
+
+        for (auto& h : hits) if (byShape.count(h.key())) return true;
         return false;
     }
 
@@ -21,5 +41,8 @@ public:
     }
 
 private:
+    Renderer2D* renderer;
     std::vector<SCButton*> buttons;
+    std::unordered_map<uint64_t, SCButton*> byShape;   // ShapeHandle::key() -> button
+    mutable std::vector<ShapeHandle> hits;
 };
@@ -31,32 +31,14 @@ void SCButton::setCallback(std::function<void()> function) {
 }
 
 void SCButton::computeHitBox() {
-    const auto& cpu    = renderer->getCPUBuffer();
-    const auto& shapes = renderer->getShapes();
-
-    const ShapeRecord* r = nullptr;
-    for (auto& s : shapes) {
-        if (s.id == handle.id) {
-            r = &s;
-            break;
-        }
-    }
+    // World bounds the renderer keeps for culling and hit tests
+    renderer->flushBounds();
+    const ShapeRecord* record = renderer->getRecord(handle);
 
-    if (!r) {
+    if (!record) {
         return;
     }
 
-    glm::vec2 minP( 9999.f );
-    glm::vec2 maxP(-9999.f );
-
-    for (int i = 0; i < r->count; ++i) {
-        const auto& v = cpu[r->offset + i].pos;
-        minP.x = std::min(minP.x, v.x);
-        minP.y = std::min(minP.y, v.y);
-        maxP.x = std::max(maxP.x, v.x);
-        maxP.y = std::max(maxP.y, v.y);
-    }
-
-    boxMin = minP;
-    boxMax = maxP;
+    boxMin = record->bounds.min;
+    boxMax = record->bounds.max;
 }
@@ -34,6 +34,8 @@ public:
                p.y >= boxMin.y && p.y <= boxMax.y;
     }
 
+    ShapeHandle getHandle() const { return handle; }
+
     glm::vec2 getBoxMin() const { return boxMin; }
     glm::vec2 getBoxMax() const { return boxMax; }
 